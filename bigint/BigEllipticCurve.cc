@@ -0,0 +1,314 @@
+#include "BigEllipticCurve.hh"
+
+BigEllipticCurve::BigEllipticCurve(const BigUnsigned &p, const BigUnsigned &a,
+		const BigUnsigned &b, const BigCurvePoint &g, const BigUnsigned &n)
+		: p(p), a(a), b(b), g(g), n(n) {
+	if (p <= BigUnsigned(3))
+		throw "BigEllipticCurve::BigEllipticCurve: The field modulus must be greater than 3";
+	if (a >= p || b >= p)
+		throw "BigEllipticCurve::BigEllipticCurve: The coefficients must be reduced modulo p";
+	aIsZero = a.isZero();
+	aIsMinus3 = (a + BigUnsigned(3) == p);
+	if (g.infinity || !contains(g))
+		throw "BigEllipticCurve::BigEllipticCurve: The generator is not on the curve";
+}
+
+// FIELD ARITHMETIC
+
+void BigEllipticCurve::fieldAdd(BigUnsigned &x, const BigUnsigned &u, const BigUnsigned &v) const {
+	x.add(u, v);
+	if (x >= p.getModulus())
+		x.subtract(x, p.getModulus());
+}
+
+void BigEllipticCurve::fieldSubtract(BigUnsigned &x, const BigUnsigned &u, const BigUnsigned &v) const {
+	if (u >= v)
+		x.subtract(u, v);
+	else {
+		// u - v + p, formed without going negative.
+		BigUnsigned temp;
+		temp.subtract(p.getModulus(), v);
+		x.add(temp, u);
+	}
+}
+
+// GROUP ARITHMETIC
+
+bool BigEllipticCurve::contains(const BigCurvePoint &P) const {
+	if (P.infinity)
+		return true;
+	if (P.x >= p.getModulus() || P.y >= p.getModulus())
+		return false;
+	// Check y^2 == (x^2 + a) * x + b.
+	BigUnsigned lhs, rhs;
+	fieldMultiply(lhs, P.y, P.y);
+	fieldMultiply(rhs, P.x, P.x);
+	fieldAdd(rhs, rhs, a);
+	fieldMultiply(rhs, rhs, P.x);
+	fieldAdd(rhs, rhs, b);
+	return lhs == rhs;
+}
+
+void BigEllipticCurve::toJacobian(JacobianPoint &R, const BigCurvePoint &P) const {
+	if (P.infinity) {
+		R.x = 1;
+		R.y = 1;
+		R.z = 0;
+	} else {
+		R.x = P.x;
+		R.y = P.y;
+		R.z = 1;
+	}
+}
+
+BigCurvePoint BigEllipticCurve::toAffine(const JacobianPoint &P) const {
+	if (P.z.isZero())
+		return BigCurvePoint();
+	// (X / Z^2, Y / Z^3), with the single inversion of the whole computation.
+	BigUnsigned zInv(modinv(P.z, p.getModulus())), zInv2, x, y;
+	fieldMultiply(zInv2, zInv, zInv);
+	fieldMultiply(x, P.x, zInv2);
+	fieldMultiply(y, P.y, zInv2);
+	fieldMultiply(y, y, zInv);
+	return BigCurvePoint(x, y);
+}
+
+/* Doubling, "dbl-2007-bl" from the Explicit-Formulas Database:
+ *     M = 3X^2 + aZ^4, S = 4XY^2,
+ *     X' = M^2 - 2S, Y' = M(S - X') - 8Y^4, Z' = 2YZ.
+ * For a == -3, M = 3(X - Z^2)(X + Z^2) saves two multiplications. */
+void BigEllipticCurve::twice(JacobianPoint &R, const JacobianPoint &P) const {
+	if (P.z.isZero() || P.y.isZero()) {
+		R.x = 1;
+		R.y = 1;
+		R.z = 0;
+		return;
+	}
+	BigUnsigned yy, s, m, t;
+	fieldMultiply(yy, P.y, P.y);
+	// S = 4XY^2
+	fieldMultiply(s, P.x, yy);
+	fieldAdd(s, s, s);
+	fieldAdd(s, s, s);
+	// M
+	if (aIsMinus3) {
+		BigUnsigned zz;
+		fieldMultiply(zz, P.z, P.z);
+		fieldSubtract(m, P.x, zz);
+		fieldAdd(t, P.x, zz);
+		fieldMultiply(m, m, t);
+		fieldAdd(t, m, m);
+		fieldAdd(m, t, m);
+	} else {
+		fieldMultiply(t, P.x, P.x);
+		fieldAdd(m, t, t);
+		fieldAdd(m, m, t);
+		if (!aIsZero) {
+			BigUnsigned zz;
+			fieldMultiply(zz, P.z, P.z);
+			fieldMultiply(zz, zz, zz);
+			fieldMultiply(zz, zz, a);
+			fieldAdd(m, m, zz);
+		}
+	}
+	// Z' = 2YZ, computed before R.y can overwrite P.y.
+	fieldMultiply(R.z, P.y, P.z);
+	fieldAdd(R.z, R.z, R.z);
+	// X' = M^2 - 2S
+	fieldMultiply(t, m, m);
+	fieldSubtract(t, t, s);
+	fieldSubtract(R.x, t, s);
+	// Y' = M(S - X') - 8Y^4
+	fieldSubtract(s, s, R.x);
+	fieldMultiply(s, s, m);
+	fieldMultiply(yy, yy, yy);
+	fieldAdd(yy, yy, yy);
+	fieldAdd(yy, yy, yy);
+	fieldAdd(yy, yy, yy);
+	fieldSubtract(R.y, s, yy);
+}
+
+/* Addition, "add-1998-cmo-2" from the Explicit-Formulas Database:
+ *     U1 = X1 Z2^2, U2 = X2 Z1^2, S1 = Y1 Z2^3, S2 = Y2 Z1^3,
+ *     H = U2 - U1, r = S2 - S1,
+ *     X' = r^2 - H^3 - 2 U1 H^2, Y' = r(U1 H^2 - X') - S1 H^3, Z' = Z1 Z2 H. */
+void BigEllipticCurve::plus(JacobianPoint &R, const JacobianPoint &P, const JacobianPoint &Q) const {
+	if (P.z.isZero()) {
+		R = Q;
+		return;
+	}
+	if (Q.z.isZero()) {
+		R = P;
+		return;
+	}
+	BigUnsigned z1z1, z2z2, u1, u2, s1, s2, h, r;
+	fieldMultiply(z1z1, P.z, P.z);
+	fieldMultiply(z2z2, Q.z, Q.z);
+	fieldMultiply(u1, P.x, z2z2);
+	fieldMultiply(u2, Q.x, z1z1);
+	fieldMultiply(s1, P.y, Q.z);
+	fieldMultiply(s1, s1, z2z2);
+	fieldMultiply(s2, Q.y, P.z);
+	fieldMultiply(s2, s2, z1z1);
+	if (u1 == u2) {
+		// Same x: either P == Q or P == -Q.
+		if (s1 == s2)
+			twice(R, P);
+		else {
+			R.x = 1;
+			R.y = 1;
+			R.z = 0;
+		}
+		return;
+	}
+	fieldSubtract(h, u2, u1);
+	fieldSubtract(r, s2, s1);
+	BigUnsigned hh, hhh, v;
+	fieldMultiply(hh, h, h);
+	fieldMultiply(hhh, hh, h);
+	fieldMultiply(v, u1, hh);
+	// Z' = Z1 Z2 H, computed before R.z can overwrite P.z or Q.z.
+	fieldMultiply(u2, P.z, Q.z);
+	fieldMultiply(R.z, u2, h);
+	// X' = r^2 - H^3 - 2V
+	fieldMultiply(u2, r, r);
+	fieldSubtract(u2, u2, hhh);
+	fieldSubtract(u2, u2, v);
+	fieldSubtract(R.x, u2, v);
+	// Y' = r(V - X') - S1 H^3
+	fieldSubtract(v, v, R.x);
+	fieldMultiply(v, v, r);
+	fieldMultiply(s1, s1, hhh);
+	fieldSubtract(R.y, v, s1);
+}
+
+void BigEllipticCurve::negate(JacobianPoint &R, const JacobianPoint &P) const {
+	R.x = P.x;
+	R.z = P.z;
+	if (P.y.isZero())
+		R.y = P.y;
+	else
+		R.y.subtract(p.getModulus(), P.y);
+}
+
+// SCALAR MULTIPLICATION
+
+namespace {
+	// Picks the NAF window width for a scalar of the given bit length.
+	unsigned int windowFor(BigUnsigned::Index bits) {
+		return (bits > 192) ? 5 : (bits > 32) ? 4 : 2;
+	}
+}
+
+void BigEllipticCurve::recode(const BigUnsigned &k, unsigned int w, int *&digits, Index &length) {
+	// A width-w NAF is at most one digit longer than the binary form.
+	digits = new int[k.bitLength() + 1];
+	length = 0;
+	BigUnsigned rest(k);
+	BigUnsigned::Blk mask = (BigUnsigned::Blk(1) << w) - 1;
+	int half = 1 << (w - 1);
+	while (!rest.isZero()) {
+		int d = 0;
+		if (rest.getBit(0)) {
+			// The signed residue of rest modulo 2^w, which is odd.
+			d = int(rest.getBlock(0) & mask);
+			if (d >= half) {
+				d -= 2 * half;
+				rest += BigUnsigned((unsigned int)(-d));
+			} else
+				rest -= BigUnsigned((unsigned int)d);
+		}
+		digits[length++] = d;
+		rest >>= 1;
+	}
+}
+
+void BigEllipticCurve::precompute(const BigCurvePoint &P, unsigned int w, JacobianPoint *table) const {
+	// table[i] = (2i + 1) P
+	toJacobian(table[0], P);
+	JacobianPoint twiceP;
+	twice(twiceP, table[0]);
+	for (int i = 1; i < (1 << (w - 2)); i++)
+		plus(table[i], table[i - 1], twiceP);
+}
+
+BigCurvePoint BigEllipticCurve::add(const BigCurvePoint &P, const BigCurvePoint &Q) const {
+	JacobianPoint jP, jQ;
+	toJacobian(jP, P);
+	toJacobian(jQ, Q);
+	plus(jP, jP, jQ);
+	return toAffine(jP);
+}
+
+BigCurvePoint BigEllipticCurve::negate(const BigCurvePoint &P) const {
+	if (P.infinity || P.y.isZero())
+		return P;
+	return BigCurvePoint(P.x, p.getModulus() - P.y);
+}
+
+BigCurvePoint BigEllipticCurve::multiply(const BigCurvePoint &P, const BigUnsigned &k) const {
+	return multiplyAdd(P, k, BigCurvePoint(), BigUnsigned());
+}
+
+BigCurvePoint BigEllipticCurve::multiplyAdd(const BigCurvePoint &P, const BigUnsigned &k1,
+		const BigCurvePoint &Q, const BigUnsigned &k2) const {
+	Index bits = k1.bitLength() > k2.bitLength() ? k1.bitLength() : k2.bitLength();
+	unsigned int w = windowFor(bits);
+	int *digits1, *digits2;
+	Index length1, length2;
+	recode(k1, w, digits1, length1);
+	recode(k2, w, digits2, length2);
+	JacobianPoint *table1 = new JacobianPoint[1 << (w - 2)];
+	JacobianPoint *table2 = new JacobianPoint[1 << (w - 2)];
+	if (length1 > 0)
+		precompute(P, w, table1);
+	if (length2 > 0)
+		precompute(Q, w, table2);
+
+	// Left to right: double once per digit and add the table entries.
+	JacobianPoint R, temp;
+	toJacobian(R, BigCurvePoint());
+	Index i = (length1 > length2) ? length1 : length2;
+	while (i > 0) {
+		i--;
+		twice(R, R);
+		int d1 = (i < length1) ? digits1[i] : 0;
+		int d2 = (i < length2) ? digits2[i] : 0;
+		if (d1 > 0)
+			plus(R, R, table1[d1 / 2]);
+		else if (d1 < 0) {
+			negate(temp, table1[-d1 / 2]);
+			plus(R, R, temp);
+		}
+		if (d2 > 0)
+			plus(R, R, table2[d2 / 2]);
+		else if (d2 < 0) {
+			negate(temp, table2[-d2 / 2]);
+			plus(R, R, temp);
+		}
+	}
+
+	delete [] digits1;
+	delete [] digits2;
+	delete [] table1;
+	delete [] table2;
+	return toAffine(R);
+}
+
+bool BigEllipticCurve::verify(const BigCurvePoint &Q, const BigUnsigned &e,
+		const BigUnsigned &r, const BigUnsigned &s) const {
+	if (Q.infinity || !contains(Q))
+		return false;
+	if (r.isZero() || s.isZero() || r >= n || s >= n)
+		return false;
+	// u1 = e / s, u2 = r / s (mod n); the signature is valid if
+	// (u1 G + u2 Q).x == r (mod n).
+	BigModulus order(n);
+	BigUnsigned sInv(modinv(s, n)), u1, u2;
+	order.multiply(u1, e % n, sInv);
+	order.multiply(u2, r, sInv);
+	BigCurvePoint X(multiplyAdd(g, u1, Q, u2));
+	if (X.infinity)
+		return false;
+	return X.x % n == r;
+}
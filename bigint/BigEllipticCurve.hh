@@ -0,0 +1,110 @@
+#ifndef BIGELLIPTICCURVE_H
+#define BIGELLIPTICCURVE_H
+
+#include "BigIntegerAlgorithms.hh"
+
+/* A BigCurvePoint is a point on an elliptic curve in affine coordinates, or
+ * the point at infinity (the neutral element of the curve group). */
+class BigCurvePoint {
+
+public:
+	BigUnsigned x, y;
+	bool infinity;
+
+	// Constructs the point at infinity.
+	BigCurvePoint() : x(), y(), infinity(true) {}
+
+	// Constructs the affine point (x, y).
+	BigCurvePoint(const BigUnsigned &x, const BigUnsigned &y)
+		: x(x), y(y), infinity(false) {}
+
+	bool operator ==(const BigCurvePoint &P) const {
+		return infinity ? P.infinity : (!P.infinity && x == P.x && y == P.y);
+	}
+	bool operator !=(const BigCurvePoint &P) const { return !operator ==(P); }
+};
+
+/* A BigEllipticCurve object is a short-Weierstrass curve y^2 = x^3 + ax + b
+ * over the prime field of order p, together with a generator g of order n.
+ *
+ * Points are taken and returned in affine coordinates, but all arithmetic
+ * in between is done in Jacobian coordinates (X, Y, Z), standing for
+ * (X / Z^2, Y / Z^3), so that a scalar multiplication needs a single
+ * inversion at the very end.  Scalars are recoded into width-w NAF form
+ * (odd digits in (-2^(w-1), 2^(w-1))), which needs one addition for about
+ * every w + 1 doublings.  Field reductions go through a BigModulus, so
+ * pseudo-Mersenne field primes get the special-form fold. */
+class BigEllipticCurve {
+
+public:
+	typedef BigUnsigned::Index Index;
+
+protected:
+	// The field modulus and the curve coefficients
+	BigModulus p;
+	BigUnsigned a, b;
+	// Whether a == 0 or a == p - 3, which allow a cheaper doubling
+	bool aIsZero, aIsMinus3;
+	// The generator and its order
+	BigCurvePoint g;
+	BigUnsigned n;
+
+	// A point in Jacobian coordinates; Z == 0 is the point at infinity.
+	struct JacobianPoint {
+		BigUnsigned x, y, z;
+	};
+
+	// FIELD ARITHMETIC.  Inputs must be reduced; x may alias the inputs.
+	void fieldAdd(BigUnsigned &x, const BigUnsigned &u, const BigUnsigned &v) const;
+	void fieldSubtract(BigUnsigned &x, const BigUnsigned &u, const BigUnsigned &v) const;
+	void fieldMultiply(BigUnsigned &x, const BigUnsigned &u, const BigUnsigned &v) const {
+		p.multiply(x, u, v);
+	}
+
+	// GROUP ARITHMETIC IN JACOBIAN COORDINATES.  R may alias P or Q.
+	void toJacobian(JacobianPoint &R, const BigCurvePoint &P) const;
+	BigCurvePoint toAffine(const JacobianPoint &P) const;
+	void twice(JacobianPoint &R, const JacobianPoint &P) const;
+	void plus(JacobianPoint &R, const JacobianPoint &P, const JacobianPoint &Q) const;
+	void negate(JacobianPoint &R, const JacobianPoint &P) const;
+
+	/* Recodes k into width-w NAF digits, least significant first, and fills
+	 * table with the odd multiples P, 3P, ..., (2^(w-1) - 1)P. */
+	static void recode(const BigUnsigned &k, unsigned int w, int *&digits, Index &length);
+	void precompute(const BigCurvePoint &P, unsigned int w, JacobianPoint *table) const;
+
+public:
+	/* Constructs a curve.  Throws if p is not greater than 3, if the
+	 * coefficients are not reduced or if g does not lie on the curve. */
+	BigEllipticCurve(const BigUnsigned &p, const BigUnsigned &a,
+			const BigUnsigned &b, const BigCurvePoint &g, const BigUnsigned &n);
+
+	// ACCESSORS
+	const BigUnsigned &getModulus() const { return p.getModulus(); }
+	const BigCurvePoint &getGenerator() const { return g; }
+	const BigUnsigned &getOrder() const { return n; }
+
+	// Checks whether P is the point at infinity or a reduced point on the curve.
+	bool contains(const BigCurvePoint &P) const;
+
+	// Returns P + Q.
+	BigCurvePoint add(const BigCurvePoint &P, const BigCurvePoint &Q) const;
+
+	// Returns -P.
+	BigCurvePoint negate(const BigCurvePoint &P) const;
+
+	// Returns k * P.
+	BigCurvePoint multiply(const BigCurvePoint &P, const BigUnsigned &k) const;
+
+	/* Returns k1 * P + k2 * Q, interleaving both scalars so that the
+	 * doublings are shared (Shamir's trick). */
+	BigCurvePoint multiplyAdd(const BigCurvePoint &P, const BigUnsigned &k1,
+			const BigCurvePoint &Q, const BigUnsigned &k2) const;
+
+	/* Verifies an ECDSA signature (r, s) on the hash e with the public key Q.
+	 * e should already be truncated to the bit length of the order n. */
+	bool verify(const BigCurvePoint &Q, const BigUnsigned &e,
+			const BigUnsigned &r, const BigUnsigned &s) const;
+};
+
+#endif
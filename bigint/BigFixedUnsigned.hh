@@ -0,0 +1,374 @@
+#ifndef BIGFIXEDUNSIGNED_H
+#define BIGFIXEDUNSIGNED_H
+
+#include "BigUnsigned.hh"
+
+/* A BigFixedUnsigned<Bits> object represents a nonnegative integer below
+ * 2^Bits, stored as a fixed array of blocks inside the object.  It is meant
+ * for hot code that works at a width known at compile time: 64-bit IDs,
+ * 128-bit hashes, 256-bit curve fields.  Bits must be a positive multiple of
+ * 64, so that the width is a whole number of blocks with either block size.
+ *
+ * There is no length to track and nothing to allocate, and every loop runs
+ * over the constant number of blocks, so the compiler unrolls them
+ * completely.  Arithmetic wraps modulo 2^Bits: add and subtract return the
+ * carry or borrow out, and multiplyFull gives the full product of two numbers
+ * of half the width.
+ *
+ * Montgomery multiplication is provided too, which reduces by an odd modulus
+ * without any division.  modexp uses it automatically for odd moduli of up to
+ * 256 bits.
+ *
+ * A value too wide for Bits throws when converted from a BigUnsigned; the
+ * conversion back never fails. */
+template <unsigned int Bits>
+class BigFixedUnsigned {
+
+public:
+	typedef BigUnsigned::Blk Blk;
+	typedef BigUnsigned::Index Index;
+	typedef BigUnsigned::CmpRes CmpRes;
+
+	// The number of bits in a block, and the number of blocks
+	static const unsigned int N = 8 * sizeof(Blk);
+	static const Index blocks = Bits / N;
+
+	static_assert(Bits > 0 && Bits % 64 == 0,
+		"BigFixedUnsigned: Bits must be a positive multiple of 64");
+
+protected:
+	// The blocks, least significant first
+	Blk blk[blocks];
+
+	// multiplyFull reads the blocks of numbers of half the width.
+	template <unsigned int> friend class BigFixedUnsigned;
+
+	/* Returns the low block of a * b + c + d and stores the high block in
+	 * high.  The result always fits in two blocks. */
+	static Blk multiplyAdd(Blk a, Blk b, Blk c, Blk d, Blk &high);
+
+public:
+	// Constructs zero.
+	BigFixedUnsigned() {
+		for (Index i = 0; i < blocks; i++)
+			blk[i] = 0;
+	}
+
+	// Constructs a number that fits in a single block.
+	explicit BigFixedUnsigned(Blk x) {
+		blk[0] = x;
+		for (Index i = 1; i < blocks; i++)
+			blk[i] = 0;
+	}
+
+	// LINKS TO BIGUNSIGNED.  The constructor throws if x is too wide.
+	explicit BigFixedUnsigned(const BigUnsigned &x);
+	operator BigUnsigned() const { return BigUnsigned(blk, blocks); }
+
+	// ACCESSORS
+	Blk getBlock(Index i) const { return i >= blocks ? 0 : blk[i]; }
+	bool getBit(Index bi) const {
+		return (getBlock(bi / N) & (Blk(1) << (bi % N))) != 0;
+	}
+	bool isZero() const;
+
+	// COMPARISONS
+	CmpRes compareTo(const BigFixedUnsigned<Bits> &x) const;
+	bool operator ==(const BigFixedUnsigned<Bits> &x) const { return compareTo(x) == BigUnsigned::equal  ; }
+	bool operator !=(const BigFixedUnsigned<Bits> &x) const { return compareTo(x) != BigUnsigned::equal  ; }
+	bool operator < (const BigFixedUnsigned<Bits> &x) const { return compareTo(x) == BigUnsigned::less   ; }
+	bool operator <=(const BigFixedUnsigned<Bits> &x) const { return compareTo(x) != BigUnsigned::greater; }
+	bool operator >=(const BigFixedUnsigned<Bits> &x) const { return compareTo(x) != BigUnsigned::less   ; }
+	bool operator > (const BigFixedUnsigned<Bits> &x) const { return compareTo(x) == BigUnsigned::greater; }
+
+	/* COPY-LESS OPERATIONS.  These work modulo 2^Bits, and the result may
+	 * alias any operand.  add and subtract return the carry or borrow out;
+	 * the shifts take an amount below Bits. */
+	Blk add(const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b);
+	Blk subtract(const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b);
+	void multiply(const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b);
+	void bitShiftLeft(const BigFixedUnsigned<Bits> &a, unsigned int b);
+	void bitShiftRight(const BigFixedUnsigned<Bits> &a, unsigned int b);
+
+	// Stores the full product of two numbers of half the width.
+	void multiplyFull(const BigFixedUnsigned<Bits / 2> &a, const BigFixedUnsigned<Bits / 2> &b);
+
+	/* MONTGOMERY ARITHMETIC with R = 2^Bits, for an odd modulus m.
+	 * montgomeryFactor returns the factor -m^-1 mod 2^N that
+	 * montgomeryMultiply needs.  montgomeryMultiply stores a * b / R mod m,
+	 * given a and b below m; the result may alias either of them.  Numbers
+	 * are brought into Montgomery form x R mod m by multiplying them with
+	 * R^2 mod m, and out of it by multiplying them with 1. */
+	static Blk montgomeryFactor(const BigFixedUnsigned<Bits> &m);
+	void montgomeryMultiply(const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b,
+			const BigFixedUnsigned<Bits> &m, Blk factor);
+
+	// OVERLOADED RETURN-BY-VALUE OPERATORS
+	BigFixedUnsigned<Bits> operator +(const BigFixedUnsigned<Bits> &x) const;
+	BigFixedUnsigned<Bits> operator -(const BigFixedUnsigned<Bits> &x) const;
+	BigFixedUnsigned<Bits> operator *(const BigFixedUnsigned<Bits> &x) const;
+	BigFixedUnsigned<Bits> operator <<(unsigned int b) const;
+	BigFixedUnsigned<Bits> operator >>(unsigned int b) const;
+
+	// OVERLOADED ASSIGNMENT OPERATORS
+	void operator +=(const BigFixedUnsigned<Bits> &x) { add(*this, x); }
+	void operator -=(const BigFixedUnsigned<Bits> &x) { subtract(*this, x); }
+	void operator *=(const BigFixedUnsigned<Bits> &x) { multiply(*this, x); }
+	void operator <<=(unsigned int b) { bitShiftLeft(*this, b); }
+	void operator >>=(unsigned int b) { bitShiftRight(*this, b); }
+};
+
+template <unsigned int Bits>
+const unsigned int BigFixedUnsigned<Bits>::N;
+
+template <unsigned int Bits>
+const typename BigFixedUnsigned<Bits>::Index BigFixedUnsigned<Bits>::blocks;
+
+template <unsigned int Bits>
+inline typename BigFixedUnsigned<Bits>::Blk BigFixedUnsigned<Bits>::multiplyAdd(
+		Blk a, Blk b, Blk c, Blk d, Blk &high) {
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	// At most (2^N - 1)^2 + 2 * (2^N - 1), which fits.
+	BigUnsignedDoubleBlk t = BigUnsignedDoubleBlk(a) * b + c + d;
+	high = Blk(t >> N);
+	return Blk(t);
+#else
+	// Multiply half blocks, then add in the carries.
+	const unsigned int H = N / 2;
+	const Blk mask = (Blk(1) << H) - 1;
+	Blk a0 = a & mask, a1 = a >> H, b0 = b & mask, b1 = b >> H;
+	Blk p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	Blk mid = (p00 >> H) + (p01 & mask) + (p10 & mask);
+	Blk low = (p00 & mask) | (mid << H);
+	high = p11 + (p01 >> H) + (p10 >> H) + (mid >> H);
+	low += c;
+	high += (low < c);
+	low += d;
+	high += (low < d);
+	return low;
+#endif
+}
+
+template <unsigned int Bits>
+BigFixedUnsigned<Bits>::BigFixedUnsigned(const BigUnsigned &x) {
+	if (x.getLength() > blocks)
+		throw "BigFixedUnsigned<Bits>::BigFixedUnsigned(const BigUnsigned &): "
+			"Value is too wide for the fixed width";
+	for (Index i = 0; i < blocks; i++)
+		blk[i] = x.getBlock(i);
+}
+
+template <unsigned int Bits>
+bool BigFixedUnsigned<Bits>::isZero() const {
+	Blk any = 0;
+	for (Index i = 0; i < blocks; i++)
+		any |= blk[i];
+	return any == 0;
+}
+
+template <unsigned int Bits>
+typename BigFixedUnsigned<Bits>::CmpRes BigFixedUnsigned<Bits>::compareTo(
+		const BigFixedUnsigned<Bits> &x) const {
+	// Compare blocks one by one from left to right.
+	for (Index i = blocks; i-- > 0; ) {
+		if (blk[i] != x.blk[i])
+			return (blk[i] > x.blk[i]) ? BigUnsigned::greater : BigUnsigned::less;
+	}
+	return BigUnsigned::equal;
+}
+
+template <unsigned int Bits>
+typename BigFixedUnsigned<Bits>::Blk BigFixedUnsigned<Bits>::add(
+		const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b) {
+	Blk carry = 0;
+	for (Index i = 0; i < blocks; i++) {
+		// Both blocks are read before block i is written.
+		Blk x = a.blk[i], sum = x + b.blk[i];
+		Blk carryOut = (sum < x);
+		sum += carry;
+		carryOut |= (sum < carry);
+		blk[i] = sum;
+		carry = carryOut;
+	}
+	return carry;
+}
+
+template <unsigned int Bits>
+typename BigFixedUnsigned<Bits>::Blk BigFixedUnsigned<Bits>::subtract(
+		const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b) {
+	Blk borrow = 0;
+	for (Index i = 0; i < blocks; i++) {
+		Blk x = a.blk[i], diff = x - b.blk[i];
+		Blk borrowOut = (diff > x);
+		borrowOut |= (diff < borrow);
+		blk[i] = diff - borrow;
+		borrow = borrowOut;
+	}
+	return borrow;
+}
+
+template <unsigned int Bits>
+void BigFixedUnsigned<Bits>::multiply(const BigFixedUnsigned<Bits> &a, const BigFixedUnsigned<Bits> &b) {
+	// Only the low half of the product is formed, in r so that *this may alias.
+	Blk r[blocks];
+	Index i, j;
+	for (i = 0; i < blocks; i++)
+		r[i] = 0;
+	for (i = 0; i < blocks; i++) {
+		Blk carry = 0, high;
+		for (j = 0; i + j < blocks; j++) {
+			r[i + j] = multiplyAdd(a.blk[i], b.blk[j], r[i + j], carry, high);
+			carry = high;
+		}
+	}
+	for (i = 0; i < blocks; i++)
+		blk[i] = r[i];
+}
+
+template <unsigned int Bits>
+void BigFixedUnsigned<Bits>::multiplyFull(const BigFixedUnsigned<Bits / 2> &a, const BigFixedUnsigned<Bits / 2> &b) {
+	const Index half = BigFixedUnsigned<Bits / 2>::blocks;
+	Index i, j;
+	for (i = 0; i < blocks; i++)
+		blk[i] = 0;
+	for (i = 0; i < half; i++) {
+		Blk carry = 0, high;
+		for (j = 0; j < half; j++) {
+			blk[i + j] = multiplyAdd(a.blk[i], b.blk[j], blk[i + j], carry, high);
+			carry = high;
+		}
+		blk[i + half] = carry;
+	}
+}
+
+template <unsigned int Bits>
+void BigFixedUnsigned<Bits>::bitShiftLeft(const BigFixedUnsigned<Bits> &a, unsigned int b) {
+	Index shiftBlocks = b / N;
+	unsigned int shiftBits = b % N;
+	// From the top down, so that each block is read before it is overwritten
+	for (Index i = blocks; i-- > 0; ) {
+		Blk x = 0;
+		if (i >= shiftBlocks) {
+			x = a.blk[i - shiftBlocks] << shiftBits;
+			if (shiftBits != 0 && i > shiftBlocks)
+				x |= a.blk[i - shiftBlocks - 1] >> (N - shiftBits);
+		}
+		blk[i] = x;
+	}
+}
+
+template <unsigned int Bits>
+void BigFixedUnsigned<Bits>::bitShiftRight(const BigFixedUnsigned<Bits> &a, unsigned int b) {
+	Index shiftBlocks = b / N;
+	unsigned int shiftBits = b % N;
+	// From the bottom up, for the same reason
+	for (Index i = 0; i < blocks; i++) {
+		Blk x = 0;
+		if (i + shiftBlocks < blocks) {
+			x = a.blk[i + shiftBlocks] >> shiftBits;
+			if (shiftBits != 0 && i + shiftBlocks + 1 < blocks)
+				x |= a.blk[i + shiftBlocks + 1] << (N - shiftBits);
+		}
+		blk[i] = x;
+	}
+}
+
+template <unsigned int Bits>
+typename BigFixedUnsigned<Bits>::Blk BigFixedUnsigned<Bits>::montgomeryFactor(
+		const BigFixedUnsigned<Bits> &m) {
+	if ((m.blk[0] & 1) == 0)
+		throw "BigFixedUnsigned<Bits>::montgomeryFactor: The modulus must be odd";
+	/* Newton's iteration for m^-1 mod 2^N.  m * m == 1 (mod 8) for odd m, so
+	 * the start is right in 3 bits, and each step doubles that. */
+	Blk m0 = m.blk[0], inverse = m0;
+	for (unsigned int bits = 3; bits < N; bits *= 2)
+		inverse *= Blk(2) - m0 * inverse;
+	return Blk(0) - inverse;
+}
+
+/* Montgomery multiplication, in the coarsely integrated operand scanning
+ * form: for each block of b, add a times it to t, then add the multiple of m
+ * that clears the low block of t and drop that block.  t stays below 2m. */
+template <unsigned int Bits>
+void BigFixedUnsigned<Bits>::montgomeryMultiply(const BigFixedUnsigned<Bits> &a,
+		const BigFixedUnsigned<Bits> &b, const BigFixedUnsigned<Bits> &m, Blk factor) {
+	Blk t[blocks + 2];
+	Index i, j;
+	for (i = 0; i < blocks + 2; i++)
+		t[i] = 0;
+	for (i = 0; i < blocks; i++) {
+		// t += a * b[i]
+		Blk carry = 0, high;
+		for (j = 0; j < blocks; j++) {
+			t[j] = multiplyAdd(a.blk[j], b.blk[i], t[j], carry, high);
+			carry = high;
+		}
+		t[blocks] += carry;
+		t[blocks + 1] = (t[blocks] < carry);
+		// t = (t + u * m) / 2^N, where u makes the low block vanish
+		Blk u = t[0] * factor;
+		multiplyAdd(u, m.blk[0], t[0], 0, carry);
+		for (j = 1; j < blocks; j++) {
+			t[j - 1] = multiplyAdd(u, m.blk[j], t[j], carry, high);
+			carry = high;
+		}
+		t[blocks - 1] = t[blocks] + carry;
+		t[blocks] = t[blocks + 1] + (t[blocks - 1] < carry);
+	}
+	// Subtract m once if t >= m.
+	bool reduce = (t[blocks] != 0);
+	if (!reduce) {
+		reduce = true;
+		for (i = blocks; i-- > 0; ) {
+			if (t[i] != m.blk[i]) {
+				reduce = (t[i] > m.blk[i]);
+				break;
+			}
+		}
+	}
+	if (reduce) {
+		Blk borrow = 0;
+		for (i = 0; i < blocks; i++) {
+			Blk diff = t[i] - m.blk[i];
+			Blk borrowOut = (diff > t[i]) | (diff < borrow);
+			blk[i] = diff - borrow;
+			borrow = borrowOut;
+		}
+	} else {
+		for (i = 0; i < blocks; i++)
+			blk[i] = t[i];
+	}
+}
+
+template <unsigned int Bits>
+inline BigFixedUnsigned<Bits> BigFixedUnsigned<Bits>::operator +(const BigFixedUnsigned<Bits> &x) const {
+	BigFixedUnsigned<Bits> ans;
+	ans.add(*this, x);
+	return ans;
+}
+template <unsigned int Bits>
+inline BigFixedUnsigned<Bits> BigFixedUnsigned<Bits>::operator -(const BigFixedUnsigned<Bits> &x) const {
+	BigFixedUnsigned<Bits> ans;
+	ans.subtract(*this, x);
+	return ans;
+}
+template <unsigned int Bits>
+inline BigFixedUnsigned<Bits> BigFixedUnsigned<Bits>::operator *(const BigFixedUnsigned<Bits> &x) const {
+	BigFixedUnsigned<Bits> ans;
+	ans.multiply(*this, x);
+	return ans;
+}
+template <unsigned int Bits>
+inline BigFixedUnsigned<Bits> BigFixedUnsigned<Bits>::operator <<(unsigned int b) const {
+	BigFixedUnsigned<Bits> ans;
+	ans.bitShiftLeft(*this, b);
+	return ans;
+}
+template <unsigned int Bits>
+inline BigFixedUnsigned<Bits> BigFixedUnsigned<Bits>::operator >>(unsigned int b) const {
+	BigFixedUnsigned<Bits> ans;
+	ans.bitShiftRight(*this, b);
+	return ans;
+}
+
+#endif
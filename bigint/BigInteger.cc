@@ -1,4 +1,5 @@
 #include "BigInteger.hh"
+#include <climits>
 
 void BigInteger::operator =(const BigInteger &x) {
 	// Calls like a = a have no effect
@@ -10,6 +11,14 @@ void BigInteger::operator =(const BigInteger &x) {
 	mag = x.mag;
 }
 
+void BigInteger::operator =(BigInteger &&x) {
+	if (this == &x)
+		return;
+	sign = x.sign;
+	mag = std::move(x.mag);
+	x.sign = zero;
+}
+
 BigInteger::BigInteger(const Blk *b, Index blen, Sign s) : mag(b, blen) {
 	switch (s) {
 	case zero:
@@ -48,23 +57,43 @@ BigInteger::BigInteger(const BigUnsigned &x, Sign s) : mag(x) {
 	}
 }
 
+BigInteger::BigInteger(BigUnsigned &&x, Sign s) : mag(std::move(x)) {
+	switch (s) {
+	case zero:
+		if (!mag.isZero())
+			throw "BigInteger::BigInteger(BigUnsigned &&, Sign): Cannot use a sign of zero with a nonzero magnitude";
+		sign = zero;
+		break;
+	case positive:
+	case negative:
+		// If the magnitude is zero, force the sign to zero.
+		sign = mag.isZero() ? zero : s;
+		break;
+	default:
+		/* g++ seems to be optimizing out this case on the assumption
+		 * that the sign is a valid member of the enumeration.  Oh well. */
+		throw "BigInteger::BigInteger(BigUnsigned &&, Sign): Invalid sign";
+	}
+}
+
 /* CONSTRUCTION FROM PRIMITIVE INTEGERS
  * Same idea as in BigUnsigned.cc, except that negative input results in a
  * negative BigInteger instead of an exception. */
 
 // Done longhand to let us use initialization.
-BigInteger::BigInteger(unsigned long  x) : mag(x) { sign = mag.isZero() ? zero : positive; }
-BigInteger::BigInteger(unsigned int   x) : mag(x) { sign = mag.isZero() ? zero : positive; }
-BigInteger::BigInteger(unsigned short x) : mag(x) { sign = mag.isZero() ? zero : positive; }
+BigInteger::BigInteger(unsigned long long x) : mag(x) { sign = mag.isZero() ? zero : positive; }
+BigInteger::BigInteger(unsigned long      x) : mag(x) { sign = mag.isZero() ? zero : positive; }
+BigInteger::BigInteger(unsigned int       x) : mag(x) { sign = mag.isZero() ? zero : positive; }
+BigInteger::BigInteger(unsigned short     x) : mag(x) { sign = mag.isZero() ? zero : positive; }
 
 // For signed input, determine the desired magnitude and sign separately.
 
 namespace {
 	template <class X, class UX>
-	BigInteger::Blk magOf(X x) {
-		/* UX(...) cast needed to stop short(-2^15), which negates to
-		 * itself, from sign-extending in the conversion to Blk. */
-		return BigInteger::Blk(x < 0 ? UX(-x) : x);
+	UX magOf(X x) {
+		/* Negating as UX is needed to stop short(-2^15), which negates to
+		 * itself, from sign-extending, and X can be wider than a block. */
+		return x < 0 ? UX(0) - UX(x) : UX(x);
 	}
 	template <class X>
 	BigInteger::Sign signOf(X x) {
@@ -74,9 +103,10 @@ namespace {
 	}
 }
 
-BigInteger::BigInteger(long  x) : sign(signOf(x)), mag(magOf<long , unsigned long >(x)) {}
-BigInteger::BigInteger(int   x) : sign(signOf(x)), mag(magOf<int  , unsigned int  >(x)) {}
-BigInteger::BigInteger(short x) : sign(signOf(x)), mag(magOf<short, unsigned short>(x)) {}
+BigInteger::BigInteger(long long x) : sign(signOf(x)), mag(magOf<long long, unsigned long long>(x)) {}
+BigInteger::BigInteger(long      x) : sign(signOf(x)), mag(magOf<long     , unsigned long     >(x)) {}
+BigInteger::BigInteger(int       x) : sign(signOf(x)), mag(magOf<int      , unsigned int      >(x)) {}
+BigInteger::BigInteger(short     x) : sign(signOf(x)), mag(magOf<short    , unsigned short    >(x)) {}
 
 // CONVERSION TO PRIMITIVE INTEGERS
 
@@ -102,20 +132,19 @@ X BigInteger::convertToUnsignedPrimitive() const {
  * nonnegative and negative numbers. */
 template <class X, class UX>
 X BigInteger::convertToSignedPrimitive() const {
+	unsigned long long b;
 	if (sign == zero)
 		return 0;
-	else if (mag.getLength() == 1) {
-		// The single block might fit in an X.  Try the conversion.
-		Blk b = mag.getBlock(0);
+	else if (mag.getSmall(b)) {
+		// The magnitude might fit in an X.  Try the conversion.
 		if (sign == positive) {
 			X x = X(b);
-			if (x >= 0 && Blk(x) == b)
+			if (x >= 0 && (unsigned long long)(x) == b)
 				return x;
 		} else {
-			X x = -X(b);
-			/* UX(...) needed to avoid rejecting conversion of
-			 * -2^15 to a short. */
-			if (x < 0 && Blk(UX(-x)) == b)
+			// Negate as UX so that -2^15 converts to a short.
+			X x = X(UX(UX(0) - UX(b)));
+			if (x < 0 && (unsigned long long)(UX(UX(0) - UX(x))) == b)
 				return x;
 		}
 		// Otherwise fall through.
@@ -124,12 +153,14 @@ X BigInteger::convertToSignedPrimitive() const {
 		"Value is too big to fit in the requested type";
 }
 
-unsigned long  BigInteger::toUnsignedLong () const { return convertToUnsignedPrimitive<unsigned long >       (); }
-unsigned int   BigInteger::toUnsignedInt  () const { return convertToUnsignedPrimitive<unsigned int  >       (); }
-unsigned short BigInteger::toUnsignedShort() const { return convertToUnsignedPrimitive<unsigned short>       (); }
-long           BigInteger::toLong         () const { return convertToSignedPrimitive  <long , unsigned long> (); }
-int            BigInteger::toInt          () const { return convertToSignedPrimitive  <int  , unsigned int>  (); }
-short          BigInteger::toShort        () const { return convertToSignedPrimitive  <short, unsigned short>(); }
+unsigned long long BigInteger::toUnsignedLongLong() const { return convertToUnsignedPrimitive<unsigned long long>                    (); }
+unsigned long      BigInteger::toUnsignedLong    () const { return convertToUnsignedPrimitive<unsigned long     >                    (); }
+unsigned int       BigInteger::toUnsignedInt     () const { return convertToUnsignedPrimitive<unsigned int      >                    (); }
+unsigned short     BigInteger::toUnsignedShort   () const { return convertToUnsignedPrimitive<unsigned short    >                    (); }
+long long          BigInteger::toLongLong        () const { return convertToSignedPrimitive  <long long, unsigned long long>(); }
+long               BigInteger::toLong            () const { return convertToSignedPrimitive  <long     , unsigned long     >(); }
+int                BigInteger::toInt             () const { return convertToSignedPrimitive  <int      , unsigned int      >(); }
+short              BigInteger::toShort           () const { return convertToSignedPrimitive  <short    , unsigned short    >(); }
 
 // COMPARISON
 BigInteger::CmpRes BigInteger::compareTo(const BigInteger &x) const {
@@ -153,21 +184,90 @@ BigInteger::CmpRes BigInteger::compareTo(const BigInteger &x) const {
 	}
 }
 
+/* SMALL VALUES
+ * Most values in practice fit in a long long: SteamIDs, counters, money.  When
+ * both operands of add, subtract or multiply do, the operation is done with
+ * native arithmetic and an overflow check, and the block loops only run when
+ * the check fails.  The magnitude keeps such values in its inline blocks, so
+ * no allocation happens either way. */
+
+// Native arithmetic with overflow checks, which GCC 5 and Clang provide
+#if (defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__)
+	#define BIGINTEGER_BUILTIN_OVERFLOW
+#endif
+
+namespace {
+	// Each of these stores the result in r and returns true unless it overflows.
+	inline bool smallAdd(long long a, long long b, long long &r) {
+#ifdef BIGINTEGER_BUILTIN_OVERFLOW
+		return !__builtin_add_overflow(a, b, &r);
+#else
+		if (b > 0 ? a > LLONG_MAX - b : a < LLONG_MIN - b)
+			return false;
+		r = a + b;
+		return true;
+#endif
+	}
+
+	inline bool smallSubtract(long long a, long long b, long long &r) {
+#ifdef BIGINTEGER_BUILTIN_OVERFLOW
+		return !__builtin_sub_overflow(a, b, &r);
+#else
+		if (b < 0 ? a > LLONG_MAX + b : a < LLONG_MIN + b)
+			return false;
+		r = a - b;
+		return true;
+#endif
+	}
+
+	inline bool smallMultiply(long long a, long long b, long long &r) {
+#ifdef BIGINTEGER_BUILTIN_OVERFLOW
+		return !__builtin_mul_overflow(a, b, &r);
+#else
+		// Without the builtin, settle for factors that can't overflow.
+		const long long limit = 1LL << 31;
+		if (a <= -limit || a >= limit || b <= -limit || b >= limit)
+			return false;
+		r = a * b;
+		return true;
+#endif
+	}
+}
+
+bool BigInteger::getSmall(long long &x) const {
+	unsigned long long m;
+	// A magnitude of 2^63 or more doesn't fit, not even -2^63, for simplicity.
+	if (!mag.getSmall(m) || (m >> 63) != 0)
+		return false;
+	x = (sign == negative) ? -(long long)(m) : (long long)(m);
+	return true;
+}
+
+void BigInteger::setSmall(long long x) {
+	if (x < 0) {
+		sign = negative;
+		// Negate as unsigned, which works for -2^63 too
+		mag.setSmall(0 - (unsigned long long)(x));
+	} else {
+		sign = (x == 0) ? zero : positive;
+		mag.setSmall((unsigned long long)(x));
+	}
+}
+
 /* COPY-LESS OPERATIONS
  * These do some messing around to determine the sign of the result,
  * then call one of BigUnsigned's copy-less operations. */
 
-// See remarks about aliased calls in BigUnsigned.cc .
-#define DTRT_ALIASED(cond, op) \
-	if (cond) { \
-		BigInteger tmpThis; \
-		tmpThis.op; \
-		*this = tmpThis; \
-		return; \
-	}
+/* See remarks about aliased calls in BigUnsigned.cc .  The operations below
+ * read each sign before writing ours and leave the magnitudes to BigUnsigned,
+ * which handles aliasing itself, so they need no temporary either. */
 
 void BigInteger::add(const BigInteger &a, const BigInteger &b) {
-	DTRT_ALIASED(this == &a || this == &b, add(a, b));
+	long long x, y, r;
+	if (a.getSmall(x) && b.getSmall(y) && smallAdd(x, y, r)) {
+		setSmall(r);
+		return;
+	}
 	// If one argument is zero, copy the other.
 	if (a.sign == zero)
 		operator =(b);
@@ -203,7 +303,11 @@ void BigInteger::add(const BigInteger &a, const BigInteger &b) {
 void BigInteger::subtract(const BigInteger &a, const BigInteger &b) {
 	// Notice that this routine is identical to BigInteger::add,
 	// if one replaces b.sign by its opposite.
-	DTRT_ALIASED(this == &a || this == &b, subtract(a, b));
+	long long x, y, r;
+	if (a.getSmall(x) && b.getSmall(y) && smallSubtract(x, y, r)) {
+		setSmall(r);
+		return;
+	}
 	// If a is zero, copy b and flip its sign.  If b is zero, copy a.
 	if (a.sign == zero) {
 		mag = b.mag;
@@ -241,7 +345,11 @@ void BigInteger::subtract(const BigInteger &a, const BigInteger &b) {
 }
 
 void BigInteger::multiply(const BigInteger &a, const BigInteger &b) {
-	DTRT_ALIASED(this == &a || this == &b, multiply(a, b));
+	long long x, y, r;
+	if (a.getSmall(x) && b.getSmall(y) && smallMultiply(x, y, r)) {
+		setSmall(r);
+		return;
+	}
 	// If one object is zero, copy zero and return.
 	if (a.sign == zero || b.sign == zero) {
 		sign = zero;
@@ -360,7 +468,6 @@ void BigInteger::divideWithRemainder(const BigInteger &b, BigInteger &q) {
 
 // Negation
 void BigInteger::negate(const BigInteger &a) {
-	DTRT_ALIASED(this == &a, negate(a));
 	// Copy a's magnitude
 	mag = a.mag;
 	// Copy the opposite of a.sign
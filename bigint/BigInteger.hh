@@ -34,9 +34,17 @@ public:
 	// Copy constructor
 	BigInteger(const BigInteger &x) : sign(x.sign), mag(x.mag) {};
 
+	// Move constructor; leaves x zero.
+	BigInteger(BigInteger &&x) : sign(x.sign), mag(std::move(x.mag)) {
+		x.sign = zero;
+	}
+
 	// Assignment operator
 	void operator=(const BigInteger &x);
 
+	// Move assignment operator; leaves x zero.
+	void operator=(BigInteger &&x);
+
 	// Constructor that copies from a given array of blocks with a sign.
 	BigInteger(const Blk *b, Index blen, Sign s);
 
@@ -48,32 +56,49 @@ public:
 	// Constructor from a BigUnsigned and a sign
 	BigInteger(const BigUnsigned &x, Sign s);
 
+	// Ditto, but takes over the blocks of x
+	BigInteger(BigUnsigned &&x, Sign s);
+
 	// Nonnegative constructor from a BigUnsigned
 	BigInteger(const BigUnsigned &x) : mag(x) {
 		sign = mag.isZero() ? zero : positive;
 	}
 
+	// Ditto, but takes over the blocks of x
+	BigInteger(BigUnsigned &&x) : mag(std::move(x)) {
+		sign = mag.isZero() ? zero : positive;
+	}
+
 	// Constructors from primitive integer types
-	BigInteger(unsigned long  x);
-	BigInteger(         long  x);
-	BigInteger(unsigned int   x);
-	BigInteger(         int   x);
-	BigInteger(unsigned short x);
-	BigInteger(         short x);
+	BigInteger(unsigned long long x);
+	BigInteger(         long long x);
+	BigInteger(unsigned long      x);
+	BigInteger(         long      x);
+	BigInteger(unsigned int       x);
+	BigInteger(         int       x);
+	BigInteger(unsigned short     x);
+	BigInteger(         short     x);
 
 	/* Converters to primitive integer types
 	 * The implicit conversion operators caused trouble, so these are now
 	 * named. */
-	unsigned long  toUnsignedLong () const;
-	long           toLong         () const;
-	unsigned int   toUnsignedInt  () const;
-	int            toInt          () const;
-	unsigned short toUnsignedShort() const;
-	short          toShort        () const;
+	unsigned long long toUnsignedLongLong() const;
+	long long          toLongLong        () const;
+	unsigned long      toUnsignedLong    () const;
+	long               toLong            () const;
+	unsigned int       toUnsignedInt     () const;
+	int                toInt             () const;
+	unsigned short     toUnsignedShort   () const;
+	short              toShort           () const;
 protected:
 	// Helper
 	template <class X> X convertToUnsignedPrimitive() const;
 	template <class X, class UX> X convertToSignedPrimitive() const;
+
+	/* Helpers for the native fast paths.  getSmall stores the value in x and
+	 * returns true if it fits in a long long; setSmall sets the value to x. */
+	bool getSmall(long long &x) const;
+	void setSmall(long long x);
 public:
 
 	// ACCESSORS
@@ -1,4 +1,5 @@
 #include "BigIntegerAlgorithms.hh"
+#include "BigFixedUnsigned.hh"
 
 BigUnsigned gcd(BigUnsigned a, BigUnsigned b) {
 	BigUnsigned trash;
@@ -52,19 +53,134 @@ BigUnsigned modinv(const BigInteger &x, const BigUnsigned &n) {
 
 BigUnsigned modexp(const BigInteger &base, const BigUnsigned &exponent,
 		const BigUnsigned &modulus) {
-	BigUnsigned ans = 1, base2 = (base % modulus).getMagnitude();
+	return modexp(base, exponent, BigModulus(modulus));
+}
+
+namespace {
+	// Returns x % modulus as a nonnegative number.
+	BigUnsigned reduceSigned(const BigInteger &x, const BigModulus &modulus) {
+		if (modulus.getModulus().isZero())
+			throw "BigInteger reduceSigned: division by zero";
+		BigUnsigned r(x.getMagnitude());
+		modulus.reduce(r);
+		if (x.getSign() == BigInteger::negative && !r.isZero())
+			r.subtract(modulus.getModulus(), r);
+		return r;
+	}
+
+	/* modexp by Montgomery multiplication at a fixed width, for an odd
+	 * modulus above 1 of at most Bits bits.  base must be reduced. */
+	template <unsigned int Bits>
+	BigUnsigned fixedModexp(const BigUnsigned &base, const BigUnsigned &exponent,
+			const BigModulus &modulus) {
+		typedef BigFixedUnsigned<Bits> Fixed;
+		Fixed m(modulus.getModulus());
+		typename Fixed::Blk factor = Fixed::montgomeryFactor(m);
+		// R^2 mod m, which brings numbers into Montgomery form
+		BigUnsigned r2;
+		r2.setBit(2 * Bits, true);
+		modulus.reduce(r2);
+		Fixed rr(r2), ans(1), base2(base);
+		ans.montgomeryMultiply(ans, rr, m, factor);
+		base2.montgomeryMultiply(base2, rr, m, factor);
+		BigUnsigned::Index i = exponent.bitLength();
+		while (i > 0) {
+			i--;
+			ans.montgomeryMultiply(ans, ans, m, factor);
+			if (exponent.getBit(i))
+				ans.montgomeryMultiply(ans, base2, m, factor);
+		}
+		// Multiplying by 1 brings the answer back out of Montgomery form.
+		ans.montgomeryMultiply(ans, Fixed(1), m, factor);
+		return ans;
+	}
+}
+
+BigUnsigned modexp(const BigInteger &base, const BigUnsigned &exponent,
+		const BigModulus &modulus) {
+	/* Odd moduli of up to 256 bits are reduced without division, by
+	 * Montgomery multiplication at the smallest fixed width that fits. */
+	const BigUnsigned &m = modulus.getModulus();
+	BigUnsigned::Index bits = m.bitLength();
+	if (m.getBit(0) && bits > 1) {
+		if (bits <= 64)
+			return fixedModexp<64>(reduceSigned(base, modulus), exponent, modulus);
+		if (bits <= 128)
+			return fixedModexp<128>(reduceSigned(base, modulus), exponent, modulus);
+		if (bits <= 256)
+			return fixedModexp<256>(reduceSigned(base, modulus), exponent, modulus);
+	}
+	BigUnsigned ans = 1, base2 = reduceSigned(base, modulus);
+	BigModulus::Workspace w;
 	BigUnsigned::Index i = exponent.bitLength();
 	// For each bit of the exponent, most to least significant...
 	while (i > 0) {
 		i--;
 		// Square.
-		ans *= ans;
-		ans %= modulus;
+		modulus.multiply(ans, ans, ans, w);
 		// And multiply if the bit is a 1.
-		if (exponent.getBit(i)) {
-			ans *= base2;
-			ans %= modulus;
-		}
+		if (exponent.getBit(i))
+			modulus.multiply(ans, ans, base2, w);
 	}
 	return ans;
 }
+
+BigUnsigned modmul(const BigInteger &a, const BigInteger &b,
+		const BigModulus &modulus) {
+	BigUnsigned ans;
+	modulus.multiply(ans, reduceSigned(a, modulus), reduceSigned(b, modulus));
+	return ans;
+}
+
+namespace {
+	// The first few primes, used for trial division and as Miller-Rabin bases.
+	const unsigned short smallPrimes[] = {
+		2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71,
+		73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151,
+		157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223, 227, 229, 233,
+		239, 241, 251
+	};
+	const unsigned int numSmallPrimes = sizeof(smallPrimes) / sizeof(smallPrimes[0]);
+}
+
+bool isProbablePrime(const BigUnsigned &n, unsigned int rounds) {
+	if (n < BigUnsigned(2))
+		return false;
+	// Trial division also settles all n below 251^2.
+	for (unsigned int i = 0; i < numSmallPrimes; i++) {
+		BigUnsigned p(smallPrimes[i]);
+		if (n == p)
+			return true;
+		if ((n % p).isZero())
+			return false;
+	}
+	if (n < BigUnsigned(251 * 251))
+		return true;
+
+	// Write n - 1 = 2^s * d with d odd.
+	BigUnsigned nMinus1(n), d;
+	nMinus1--;
+	BigUnsigned::Index s = 0;
+	while (!nMinus1.getBit(s))
+		s++;
+	d.bitShiftRight(nMinus1, s);
+
+	BigModulus modulus(n);
+	if (rounds > numSmallPrimes)
+		rounds = numSmallPrimes;
+	for (unsigned int i = 0; i < rounds; i++) {
+		BigUnsigned x(modexp(BigUnsigned(smallPrimes[i]), d, modulus));
+		if (x == BigUnsigned(1) || x == nMinus1)
+			continue;
+		BigModulus::Workspace w;
+		BigUnsigned::Index j;
+		for (j = 1; j < s; j++) {
+			modulus.multiply(x, x, x, w);
+			if (x == nMinus1)
+				break;
+		}
+		if (j == s)
+			return false;
+	}
+	return true;
+}
@@ -2,6 +2,7 @@
 #define BIGINTEGERALGORITHMS_H
 
 #include "BigInteger.hh"
+#include "BigModulus.hh"
 
 /* Some mathematical algorithms for big integers.
  * This code is new and, as such, experimental. */
@@ -22,4 +23,19 @@ BigUnsigned modinv(const BigInteger &x, const BigUnsigned &n);
 BigUnsigned modexp(const BigInteger &base, const BigUnsigned &exponent,
 		const BigUnsigned &modulus);
 
+/* Same, but reduces through a modulus context, which uses the special-form
+ * fold if the modulus has the form 2^k - c. */
+BigUnsigned modexp(const BigInteger &base, const BigUnsigned &exponent,
+		const BigModulus &modulus);
+
+// Returns (a * b) % modulus, which is nonnegative even if a or b is not.
+BigUnsigned modmul(const BigInteger &a, const BigInteger &b,
+		const BigModulus &modulus);
+
+/* Miller-Rabin test using the first `rounds' primes (at most 54) as bases,
+ * after trial division by small primes.  Returns false if n is certainly
+ * composite.  Fixed bases are fine for random candidates, but composites can
+ * be constructed to pass them. */
+bool isProbablePrime(const BigUnsigned &n, unsigned int rounds);
+
 #endif
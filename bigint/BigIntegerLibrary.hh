@@ -1,8 +1,17 @@
 // This header file includes all of the library header files.
 
 #include "NumberlikeArray.hh"
+#include "BigPool.hh"
+#include "BigScratch.hh"
 #include "BigUnsigned.hh"
+#include "BigFixedUnsigned.hh"
 #include "BigInteger.hh"
+#include "BigModulus.hh"
 #include "BigIntegerAlgorithms.hh"
 #include "BigUnsignedInABase.hh"
+#include "BigUnsignedInRNS.hh"
+#include "BigUnsignedInDecimal.hh"
+#include "BigRadix.hh"
 #include "BigIntegerUtils.hh"
+#include "BigEllipticCurve.hh"
+#include "BigRSA.hh"
@@ -1,8 +1,339 @@
 #include "BigIntegerUtils.hh"
 #include "BigUnsignedInABase.hh"
+#include "BigRadix.hh"
+#include "BigScratch.hh"
+#include <cstring>
+
+namespace {
+	// "00" through "99", for writing two decimal digits at a time
+	const char digitPairs[] =
+		"0001020304050607080910111213141516171819"
+		"2021222324252627282930313233343536373839"
+		"4041424344454647484950515253545556575859"
+		"6061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+
+	const char digitSymbols[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	const unsigned char noDigit = 0xFF;
+
+	/* The digits of a base: the symbol for each digit value and, for parsing,
+	 * the value of each symbol, or noDigit.  Standard decimal digits get the
+	 * fast paths. */
+	struct Digits {
+		unsigned int base;
+		const char *symbols;
+		const unsigned char *values;
+		bool decimal;
+	};
+
+	// Symbol values for the standard digits 0-9 and A-Z, also accepting a-z
+	const unsigned char *standardValues() {
+		static unsigned char values[256];
+		static bool initialized = false;
+		if (!initialized) {
+			unsigned int i;
+			for (i = 0; i < 256; i++)
+				values[i] = noDigit;
+			for (i = 0; i < 36; i++) {
+				values[(unsigned char)digitSymbols[i]] = (unsigned char)i;
+				if (i >= 10)
+					values[(unsigned char)(digitSymbols[i] - 'A' + 'a')] = (unsigned char)i;
+			}
+			initialized = true;
+		}
+		return values;
+	}
+
+	// The standard digits of a base from 2 to 36
+	Digits standardDigits(unsigned int base) {
+		Digits d;
+		d.base = base;
+		d.symbols = digitSymbols;
+		d.values = standardValues();
+		d.decimal = (base == 10);
+		return d;
+	}
+
+	/* The digits given by an alphabet, filling in values (256 entries).
+	 * Throws unless the alphabet has 2 to 255 distinct symbols. */
+	Digits alphabetDigits(const char *alphabet, unsigned char *values) {
+		size_t base = strlen(alphabet);
+		if (base < 2 || base > 255)
+			throw "Alphabet: An alphabet needs 2 to 255 symbols";
+		unsigned int i;
+		for (i = 0; i < 256; i++)
+			values[i] = noDigit;
+		for (i = 0; i < base; i++) {
+			unsigned char symbol = (unsigned char)alphabet[i];
+			if (values[symbol] != noDigit)
+				throw "Alphabet: The symbols of an alphabet must be distinct";
+			values[symbol] = (unsigned char)i;
+		}
+		Digits d;
+		d.base = (unsigned int)base;
+		d.symbols = alphabet;
+		d.values = values;
+		d.decimal = false;
+		return d;
+	}
+
+	/* Writes chunk with the digits so that it ends just before end, padded
+	 * with zero digits to width, and returns where it starts.  Decimal goes
+	 * two digits at a time. */
+	char *writeChunk(char *end, BigUnsigned::Blk chunk, const Digits &d, unsigned int width) {
+		char *p = end;
+		if (d.decimal) {
+			while (chunk >= 100) {
+				unsigned int pair = (unsigned int)(chunk % 100) * 2;
+				chunk /= 100;
+				p -= 2;
+				p[0] = digitPairs[pair];
+				p[1] = digitPairs[pair + 1];
+			}
+			if (chunk >= 10) {
+				unsigned int pair = (unsigned int)chunk * 2;
+				p -= 2;
+				p[0] = digitPairs[pair];
+				p[1] = digitPairs[pair + 1];
+			} else if (chunk > 0 || p == end)
+				*--p = char('0' + chunk);
+		} else {
+			do {
+				*--p = d.symbols[chunk % d.base];
+				chunk /= d.base;
+			} while (chunk != 0);
+		}
+		while ((unsigned int)(end - p) < width)
+			*--p = d.symbols[0];
+		return p;
+	}
+
+	// Returns the number of digits of chunk in the base, at least 1.
+	unsigned int chunkLength(BigUnsigned::Blk chunk, unsigned int base) {
+		unsigned int digits = 1;
+		while (chunk >= base) {
+			chunk /= base;
+			digits++;
+		}
+		return digits;
+	}
+
+	// Returns log2(base) if the base is a power of two, otherwise 0.
+	unsigned int bitsPerDigit(unsigned int base) {
+		unsigned int bits = 0;
+		if ((base & (base - 1)) != 0)
+			return 0;
+		while ((1U << bits) < base)
+			bits++;
+		return bits;
+	}
+
+	/* writeDigits for power-of-two bases: each digit is a bit field, so the
+	 * digits are read straight out of the blocks, most significant first,
+	 * and only as many as fit are produced. */
+	size_t bitFieldsToChars(const BigUnsigned &x, unsigned int digitBits, const Digits &d,
+			char *buf, size_t size) {
+		size_t length = x.isZero() ? 1 : (size_t(x.bitLength()) + digitBits - 1) / digitBits;
+		if (size == 0)
+			return length;
+		size_t count = length < size ? length : size - 1;
+		BigUnsigned::Blk mask = (BigUnsigned::Blk(1) << digitBits) - 1;
+		for (size_t i = 0; i < count; i++) {
+			size_t bitNum = (length - 1 - i) * digitBits;
+			BigUnsigned::Index blockNum = BigUnsigned::Index(bitNum / BigUnsigned::N);
+			unsigned int offset = (unsigned int)(bitNum % BigUnsigned::N);
+			BigUnsigned::Blk field = x.getBlock(blockNum) >> offset;
+			// A digit may straddle two blocks.
+			if (offset + digitBits > BigUnsigned::N)
+				field |= x.getBlock(blockNum + 1) << (BigUnsigned::N - offset);
+			buf[i] = d.symbols[field & mask];
+		}
+		buf[count] = '\0';
+		return length;
+	}
+
+	// The body of bigUnsignedToChars and bigUnsignedToAlphabet
+	size_t writeDigits(const BigUnsigned &x, const Digits &d, char *buf, size_t size) {
+		unsigned int digitBits = bitsPerDigit(d.base);
+		if (digitBits != 0 || x.isZero())
+			return bitFieldsToChars(x, digitBits != 0 ? digitBits : 1, d, buf, size);
+
+		BigUnsigned::Blk power;
+		unsigned int chunkDigits;
+		radixChunk(d.base, power, chunkDigits);
+		BigUnsigned::Index chunkCount;
+		BigUnsigned::Blk *chunks = bigUnsignedToChunks(x, d.base, chunkCount);
+		// Every chunk but the most significant one has exactly chunkDigits digits.
+		size_t length = size_t(chunkCount - 1) * chunkDigits
+			+ chunkLength(chunks[chunkCount - 1], d.base);
+		if (length < size) {
+			// Everything fits, so write the chunks in place from the end.
+			char *p = buf + length;
+			*p = '\0';
+			for (BigUnsigned::Index i = 0; i < chunkCount; i++)
+				p = writeChunk(p, chunks[i], d, i == chunkCount - 1 ? 0 : chunkDigits);
+		} else if (size > 0) {
+			/* Only the leading digits fit: stage the chunks one at a time, most
+			 * significant first, and copy out what there is room for. */
+			char staging[8 * sizeof(BigUnsigned::Blk)];
+			char *stagingEnd = staging + sizeof(staging);
+			size_t written = 0;
+			for (BigUnsigned::Index i = chunkCount; i > 0 && written < size - 1; i--) {
+				char *p = writeChunk(stagingEnd, chunks[i - 1], d,
+					i == chunkCount ? 0 : chunkDigits);
+				size_t n = size_t(stagingEnd - p);
+				if (n > size - 1 - written)
+					n = size - 1 - written;
+				memcpy(buf + written, p, n);
+				written += n;
+			}
+			buf[written] = '\0';
+		}
+		delete [] chunks;
+		return length;
+	}
+
+	/* Checks and converts eight decimal digits at once, SWAR style: the
+	 * characters are loaded into one 64-bit word, every byte is checked to be
+	 * in '0'..'9' with two masks, and the digits are combined pairwise with
+	 * three multiplications.  Returns false on a bad symbol.  The combining
+	 * step depends on the first character landing in the lowest byte. */
+	bool parseEightDigits(const char *s, unsigned long long &value) {
+		unsigned long long x;
+		memcpy(&x, s, 8);
+		if (((x & 0xF0F0F0F0F0F0F0F0ULL)
+				| (((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+				!= 0x3333333333333333ULL)
+			return false;
+		x -= 0x3030303030303030ULL;
+		x = x * 10 + (x >> 8);
+		x = (((x & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+			+ (((x >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+		value = x;
+		return true;
+	}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	const bool swarDigits = false;
+#else
+	const bool swarDigits = true;
+#endif
+
+	/* Parses count decimal digits into a chunk, eight at a time where
+	 * possible.  Returns false on a bad symbol. */
+	bool parseDecimalChunk(const char *s, unsigned int count, BigUnsigned::Blk &chunk) {
+		BigUnsigned::Blk value = 0;
+		unsigned int i = 0;
+		if (swarDigits) {
+			for (; i + 8 <= count; i += 8) {
+				unsigned long long eight;
+				if (!parseEightDigits(s + i, eight))
+					return false;
+				value = value * 100000000 + BigUnsigned::Blk(eight);
+			}
+		}
+		for (; i < count; i++) {
+			if (s[i] < '0' || s[i] > '9')
+				return false;
+			value = value * 10 + BigUnsigned::Blk(s[i] - '0');
+		}
+		chunk = value;
+		return true;
+	}
+
+	// Parses count digits into a chunk.  Returns false on a bad symbol.
+	bool parseChunk(const char *s, unsigned int count, const Digits &d, BigUnsigned::Blk &chunk) {
+		if (d.decimal)
+			return parseDecimalChunk(s, count, chunk);
+		BigUnsigned::Blk value = 0;
+		for (unsigned int i = 0; i < count; i++) {
+			unsigned int digit = d.values[(unsigned char)s[i]];
+			if (digit >= d.base)
+				return false;
+			value = value * d.base + digit;
+		}
+		chunk = value;
+		return true;
+	}
+
+	/* readDigits for power-of-two bases: each symbol is a bit field, so the
+	 * blocks are assembled directly from the end of the string. */
+	BigUnsigned charsToBitFields(const char *s, size_t length, unsigned int digitBits,
+			const Digits &d, const char *badSymbol) {
+		BigUnsigned::Index numBlocks = BigUnsigned::Index(
+			(length * digitBits + BigUnsigned::N - 1) / BigUnsigned::N);
+		BigScratchFrame scratch;
+		BigUnsigned::Blk *blocks = scratch.take(numBlocks);
+		BigUnsigned::Index i;
+		for (i = 0; i < numBlocks; i++)
+			blocks[i] = 0;
+		for (size_t digitNum = 0; digitNum < length; digitNum++) {
+			unsigned int digit = d.values[(unsigned char)s[length - 1 - digitNum]];
+			if (digit >= d.base)
+				throw badSymbol;
+			size_t bitNum = digitNum * digitBits;
+			BigUnsigned::Index blockNum = BigUnsigned::Index(bitNum / BigUnsigned::N);
+			unsigned int offset = (unsigned int)(bitNum % BigUnsigned::N);
+			blocks[blockNum] |= BigUnsigned::Blk(digit) << offset;
+			// A digit may straddle two blocks.
+			if (offset + digitBits > BigUnsigned::N)
+				blocks[blockNum + 1] |= BigUnsigned::Blk(digit) >> (BigUnsigned::N - offset);
+		}
+		return BigUnsigned(blocks, numBlocks);
+	}
+
+	/* The body of charsToBigUnsigned and alphabetToBigUnsigned.  Throws
+	 * badSymbol on a symbol that is not a digit. */
+	BigUnsigned readDigits(const char *s, size_t length, const Digits &d, const char *badSymbol) {
+		unsigned int digitBits = bitsPerDigit(d.base);
+		if (digitBits != 0)
+			return charsToBitFields(s, length, digitBits, d, badSymbol);
+
+		BigUnsigned::Blk power;
+		unsigned int chunkDigits;
+		radixChunk(d.base, power, chunkDigits);
+
+		/* Read the digits in chunks that fit in a block, from the end.  Short
+		 * inputs, such as 64-bit IDs, need only a few chunks; keep those on
+		 * the stack and borrow longer arrays from the scratch arena. */
+		BigUnsigned::Index chunkCount = BigUnsigned::Index((length + chunkDigits - 1) / chunkDigits);
+		BigUnsigned::Blk stackChunks[8];
+		BigScratchFrame scratch;
+		BigUnsigned::Blk *chunks = (chunkCount <= 8) ? stackChunks : scratch.take(chunkCount);
+		for (BigUnsigned::Index chunkNum = 0; chunkNum < chunkCount; chunkNum++) {
+			size_t end = length - size_t(chunkNum) * chunkDigits;
+			size_t start = (end > chunkDigits) ? end - chunkDigits : 0;
+			if (!parseChunk(s + start, (unsigned int)(end - start), d, chunks[chunkNum]))
+				throw badSymbol;
+		}
+		// A single chunk is already the block.
+		if (chunkCount == 1)
+			return BigUnsigned(chunks[0]);
+		return chunksToBigUnsigned(chunks, chunkCount, d.base);
+	}
+}
 
 std::string bigUnsignedToString(const BigUnsigned &x) {
-	return std::string(BigUnsignedInABase(x, 10));
+	if (x.isZero())
+		return std::string("0");
+	/* 10^9 for 32-bit blocks and 10^19 for 64-bit blocks; chunks come least
+	 * significant first, so fill the buffer from the end. */
+	BigUnsigned::Blk power;
+	unsigned int chunkDigits;
+	radixChunk(10, power, chunkDigits);
+	BigUnsigned::Index chunkCount;
+	BigUnsigned::Blk *chunks = bigUnsignedToChunks(x, 10, chunkCount);
+	Digits decimal(standardDigits(10));
+	size_t size = size_t(chunkCount) * chunkDigits;
+	char *s = new char[size];
+	char *p = s + size;
+	for (BigUnsigned::Index i = 0; i < chunkCount; i++)
+		p = writeChunk(p, chunks[i], decimal, i == chunkCount - 1 ? 0 : chunkDigits);
+	std::string s2(p, s + size - p);
+	delete [] s;
+	delete [] chunks;
+	return s2;
 }
 
 std::string bigIntegerToString(const BigInteger &x) {
@@ -11,15 +342,150 @@ std::string bigIntegerToString(const BigInteger &x) {
 		: (bigUnsignedToString(x.getMagnitude()));
 }
 
+size_t bigUnsignedToChars(const BigUnsigned &x, unsigned int base, char *buf, size_t size) {
+	if (base < 2 || base > 36)
+		throw "bigUnsignedToChars: The base must be between 2 and 36";
+	return writeDigits(x, standardDigits(base), buf, size);
+}
+
+size_t bigIntegerToChars(const BigInteger &x, unsigned int base, char *buf, size_t size) {
+	if (x.getSign() != BigInteger::negative)
+		return bigUnsignedToChars(x.getMagnitude(), base, buf, size);
+	// The '-' may only go where it leaves room for the terminator.
+	if (size <= 1) {
+		if (size == 1)
+			buf[0] = '\0';
+		return 1 + bigUnsignedToChars(x.getMagnitude(), base, NULL, 0);
+	}
+	buf[0] = '-';
+	return 1 + bigUnsignedToChars(x.getMagnitude(), base, buf + 1, size - 1);
+}
+
+BigUnsigned charsToBigUnsigned(const char *s, size_t length, unsigned int base) {
+	if (base < 2 || base > 36)
+		throw "charsToBigUnsigned: The base must be between 2 and 36";
+	return readDigits(s, length, standardDigits(base),
+		"charsToBigUnsigned: Bad symbol in input.  Only 0-9, A-Z, a-z below the base are accepted.");
+}
+
+BigInteger charsToBigInteger(const char *s, size_t length, unsigned int base) {
+	// Recognize a sign followed by a BigUnsigned.
+	if (length > 0 && s[0] == '-')
+		return BigInteger(charsToBigUnsigned(s + 1, length - 1, base), BigInteger::negative);
+	if (length > 0 && s[0] == '+')
+		return BigInteger(charsToBigUnsigned(s + 1, length - 1, base));
+	return BigInteger(charsToBigUnsigned(s, length, base));
+}
+
+size_t bigUnsignedToAlphabet(const BigUnsigned &x, const char *alphabet, char *buf, size_t size) {
+	unsigned char values[256];
+	return writeDigits(x, alphabetDigits(alphabet, values), buf, size);
+}
+
+BigUnsigned alphabetToBigUnsigned(const char *s, size_t length, const char *alphabet) {
+	unsigned char values[256];
+	return readDigits(s, length, alphabetDigits(alphabet, values),
+		"alphabetToBigUnsigned: Bad symbol in input.  Only symbols of the alphabet are accepted.");
+}
+
 BigUnsigned stringToBigUnsigned(const std::string &s) {
-	return BigUnsigned(BigUnsignedInABase(s, 10));
+	return charsToBigUnsigned(s.data(), s.length(), 10);
 }
 
 BigInteger stringToBigInteger(const std::string &s) {
-	// Recognize a sign followed by a BigUnsigned.
-	return (s[0] == '-') ? BigInteger(stringToBigUnsigned(s.substr(1, s.length() - 1)), BigInteger::negative)
-		: (s[0] == '+') ? BigInteger(stringToBigUnsigned(s.substr(1, s.length() - 1)))
-		: BigInteger(stringToBigUnsigned(s));
+	return charsToBigInteger(s.data(), s.length(), 10);
+}
+
+BigUnsigned bigIntegerToTwosComplement(const BigInteger &x, BigUnsigned::Index bits) {
+	if (twosComplementBitLength(x) > bits)
+		throw "bigIntegerToTwosComplement: The value does not fit in the given number of bits";
+	if (x.getSign() != BigInteger::negative)
+		return x.getMagnitude();
+	// 2^bits - |x|
+	BigUnsigned field;
+	field.setBit(bits, true);
+	return field - x.getMagnitude();
+}
+
+BigInteger twosComplementToBigInteger(const BigUnsigned &x, BigUnsigned::Index bits) {
+	// The top bit of the field is the sign.
+	if (bits == 0 || !x.getBit(bits - 1))
+		return BigInteger(x);
+	BigUnsigned field;
+	field.setBit(bits, true);
+	return BigInteger(field - x, BigInteger::negative);
+}
+
+BigUnsigned::Index twosComplementBitLength(const BigInteger &x) {
+	/* A nonnegative x needs a clear sign bit above its magnitude; a negative
+	 * one fits in n bits if |x| <= 2^(n - 1), i.e. if |x| - 1 has fewer
+	 * than n bits. */
+	if (x.getSign() != BigInteger::negative)
+		return x.getMagnitude().bitLength() + 1;
+	return (x.getMagnitude() - BigUnsigned(1)).bitLength() + 1;
+}
+
+BigDigitStream::BigDigitStream(const BigInteger &x, unsigned int base)
+		: chunks(NULL), chunkCount(0), chunksLeft(0), base(base) {
+	init(x.getMagnitude(), x.getSign() == BigInteger::negative);
+}
+
+BigDigitStream::BigDigitStream(const BigUnsigned &x, unsigned int base)
+		: chunks(NULL), chunkCount(0), chunksLeft(0), base(base) {
+	init(x, false);
+}
+
+void BigDigitStream::init(const BigUnsigned &magnitude, bool negative) {
+	if (base < 2 || base > 36)
+		throw "BigDigitStream: The base must be between 2 and 36";
+	char *stagingEnd = staging + sizeof(staging);
+	BigUnsigned::Blk power;
+	radixChunk(base, power, chunkDigits);
+	if (magnitude.isZero()) {
+		pending = stagingEnd - 1;
+		*pending = '0';
+		length = 1;
+		return;
+	}
+	chunks = bigUnsignedToChunks(magnitude, base, chunkCount);
+	chunksLeft = chunkCount;
+	length = size_t(chunkCount - 1) * chunkDigits + chunkLength(chunks[chunkCount - 1], base);
+	// The sign goes first, like a chunk of its own.
+	pending = stagingEnd;
+	if (negative) {
+		*--pending = '-';
+		length++;
+	}
+}
+
+BigDigitStream::~BigDigitStream() {
+	delete [] chunks;
+}
+
+size_t BigDigitStream::read(char *buf, size_t size) {
+	if (size == 0)
+		return 0;
+	char *stagingEnd = staging + sizeof(staging);
+	Digits d(standardDigits(base));
+	size_t written = 0;
+	while (written < size - 1) {
+		if (pending == stagingEnd) {
+			if (chunksLeft == 0)
+				break;
+			// Only the most significant chunk goes without leading zeros.
+			bool first = (chunksLeft == chunkCount);
+			chunksLeft--;
+			pending = writeChunk(stagingEnd, chunks[chunksLeft], d, first ? 0 : chunkDigits);
+		}
+		size_t n = size_t(stagingEnd - pending);
+		if (n > size - 1 - written)
+			n = size - 1 - written;
+		memcpy(buf + written, pending, n);
+		pending += n;
+		written += n;
+	}
+	buf[written] = '\0';
+	return written;
 }
 
 std::ostream &operator <<(std::ostream &os, const BigUnsigned &x) {
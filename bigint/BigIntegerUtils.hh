@@ -4,9 +4,11 @@
 #include "BigInteger.hh"
 #include <string>
 #include <iostream>
+#include <cstddef>
 
 /* This file provides:
  * - Convenient std::string <-> BigUnsigned/BigInteger conversion routines
+ * - Routines that write BigUnsigned/BigInteger digits into a caller's buffer
  * - std::ostream << operators for BigUnsigned/BigInteger */
 
 // std::string conversion routines.  Base 10 only.
@@ -15,10 +17,89 @@ std::string bigIntegerToString(const BigInteger &x);
 BigUnsigned stringToBigUnsigned(const std::string &s);
 BigInteger stringToBigInteger(const std::string &s);
 
+/* Writes x in the given base (2 to 36, digits 0-9 and A-Z) to buf, like
+ * snprintf: at most size - 1 characters are written, followed by a '\0' if
+ * size is nonzero, and the full length of the representation (without the
+ * '\0') is returned.  Pass a size of 0 to get just the length.  A negative
+ * BigInteger gets a leading '-'.  Throws if the base is out of range. */
+size_t bigUnsignedToChars(const BigUnsigned &x, unsigned int base, char *buf, size_t size);
+size_t bigIntegerToChars(const BigInteger &x, unsigned int base, char *buf, size_t size);
+
+/* Parses the first length characters of s in the given base (2 to 36; digits
+ * above 9 may be upper or lower case) without copying them first.  The
+ * BigInteger version also accepts a leading '+' or '-'.  An empty digit
+ * string is zero.  Throws on a bad symbol or an out-of-range base. */
+BigUnsigned charsToBigUnsigned(const char *s, size_t length, unsigned int base);
+BigInteger charsToBigInteger(const char *s, size_t length, unsigned int base);
+
+/* The same conversions with the digits of a caller's alphabet, such as the
+ * 58 symbols of base58: the base is the length of the alphabet, which must
+ * consist of 2 to 255 distinct symbols, and symbol i stands for digit i.
+ * Parsing is exact, so case matters.  Throw if the alphabet is invalid. */
+size_t bigUnsignedToAlphabet(const BigUnsigned &x, const char *alphabet, char *buf, size_t size);
+BigUnsigned alphabetToBigUnsigned(const char *s, size_t length, const char *alphabet);
+
+/* A BigDigitStream hands out the digits of a BigInteger in a base from 2 to
+ * 36, most significant first, a buffer at a time, with a leading '-' if the
+ * number is negative.  The number is split into chunks of digits when the
+ * stream is made; each call to read turns only as many chunks into
+ * characters as fit, so the whole string never exists at once. */
+class BigDigitStream {
+	BigUnsigned::Blk *chunks;
+	BigUnsigned::Index chunkCount, chunksLeft;
+	unsigned int base, chunkDigits;
+	size_t length;
+	// The characters of the chunk being read, from pending to the end
+	char staging[8 * sizeof(BigUnsigned::Blk)];
+	char *pending;
+
+	// Streams can't be copied.
+	BigDigitStream(const BigDigitStream &);
+	void operator =(const BigDigitStream &);
+
+	void init(const BigUnsigned &magnitude, bool negative);
+
+public:
+	/* Throws if the base is out of range.  A BigUnsigned is streamed
+	 * straight from its blocks, without a sign. */
+	BigDigitStream(const BigInteger &x, unsigned int base);
+	BigDigitStream(const BigUnsigned &x, unsigned int base);
+	~BigDigitStream();
+
+	// The total number of characters
+	size_t getLength() const { return length; }
+	// Whether every character has been read
+	bool isAtEnd() const { return chunksLeft == 0 && pending == staging + sizeof(staging); }
+
+	/* Writes the next characters to buf, at most size - 1 of them followed
+	 * by a '\0' if size is nonzero, and returns how many were written, which
+	 * is 0 once the stream is at its end. */
+	size_t read(char *buf, size_t size);
+};
+
 // Creates a BigInteger from data such as `char's; read below for details.
 template <class T>
 BigInteger dataToBigInteger(const T* data, BigInteger::Index length, BigInteger::Sign sign);
 
+/* Converts between BigUnsigneds and byte strings, such as the octet strings
+ * of cryptographic standards, big-endian unless asked otherwise; read below
+ * for details. */
+template <class T>
+BigUnsigned bytesToBigUnsigned(const T *bytes, BigUnsigned::Index length, bool littleEndian = false);
+template <class T>
+bool bigUnsignedToBytes(const BigUnsigned &x, T *bytes, BigUnsigned::Index length, bool littleEndian = false);
+
+// The inverse of dataToBigInteger for the magnitude; read below for details.
+template <class T>
+bool bigUnsignedToData(const BigUnsigned &x, T *data, BigUnsigned::Index length);
+
+/* Two's complement in a field of `bits' bits.  bigIntegerToTwosComplement
+ * throws if x does not fit; twosComplementBitLength gives the smallest field
+ * that x fits in, counting the sign bit. */
+BigUnsigned bigIntegerToTwosComplement(const BigInteger &x, BigUnsigned::Index bits);
+BigInteger twosComplementToBigInteger(const BigUnsigned &x, BigUnsigned::Index bits);
+BigUnsigned::Index twosComplementBitLength(const BigInteger &x);
+
 // Outputs x to os, obeying the flags `dec', `hex', `bin', and `showbase'.
 std::ostream &operator <<(std::ostream &os, const BigUnsigned &x);
 
@@ -69,4 +150,64 @@ BigInteger dataToBigInteger(const T* data, BigInteger::Index length, BigInteger:
 	return x;
 }
 
+/*
+ * Converts a byte string to a BigUnsigned.  The low 8 bits of each element of
+ * `bytes' hold one byte, so both `unsigned char' strings and arrays of larger
+ * integers with one byte per element work.  The bytes are packed straight
+ * into blocks; no base conversion is involved.
+ */
+template <class T>
+BigUnsigned bytesToBigUnsigned(const T *bytes, BigUnsigned::Index length, bool littleEndian) {
+	const unsigned int bytesPerBlock = sizeof(BigUnsigned::Blk);
+	BigUnsigned::Index numBlocks = (length + bytesPerBlock - 1) / bytesPerBlock;
+	BigUnsigned::Blk *blocks = new BigUnsigned::Blk[numBlocks];
+
+	// Byte i counted from the least significant end belongs to block i / bytesPerBlock.
+	BigUnsigned::Index i;
+	for (i = 0; i < numBlocks; i++)
+		blocks[i] = 0;
+	for (i = 0; i < length; i++)
+		blocks[i / bytesPerBlock] |= BigUnsigned::Blk(bytes[littleEndian ? i : length - 1 - i] & 0xFF)
+			<< (8 * (i % bytesPerBlock));
+
+	BigUnsigned x(blocks, numBlocks);
+	delete [] blocks;
+	return x;
+}
+
+/*
+ * Writes x as a byte string of exactly `length' bytes, padding with zeros at
+ * the most significant end.  Returns false (leaving `bytes' unspecified) if x
+ * needs more than `length' bytes.
+ */
+template <class T>
+bool bigUnsignedToBytes(const BigUnsigned &x, T *bytes, BigUnsigned::Index length, bool littleEndian) {
+	const unsigned int bytesPerBlock = sizeof(BigUnsigned::Blk);
+	if ((x.bitLength() + 7) / 8 > length)
+		return false;
+	BigUnsigned::Index i;
+	for (i = 0; i < length; i++)
+		bytes[littleEndian ? i : length - 1 - i] = T((x.getBlock(i / bytesPerBlock)
+			>> (8 * (i % bytesPerBlock))) & 0xFF);
+	return true;
+}
+
+/*
+ * Writes the magnitude x to exactly `length' elements of `data', least
+ * significant first, padding with zeros.  `T' must meet the same two
+ * requirements as for dataToBigInteger; in addition, it should be unsigned.
+ * Returns false (leaving `data' unspecified) if x does not fit.
+ */
+template <class T>
+bool bigUnsignedToData(const BigUnsigned &x, T *data, BigUnsigned::Index length) {
+	const unsigned int pieceSizeInBits = 8 * sizeof(T);
+	const unsigned int piecesPerBlock = sizeof(BigUnsigned::Blk) / sizeof(T);
+	if ((x.bitLength() + pieceSizeInBits - 1) / pieceSizeInBits > length)
+		return false;
+	BigUnsigned::Index i;
+	for (i = 0; i < length; i++)
+		data[i] = T(x.getBlock(i / piecesPerBlock) >> (pieceSizeInBits * (i % piecesPerBlock)));
+	return true;
+}
+
 #endif
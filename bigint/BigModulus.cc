@@ -0,0 +1,68 @@
+#include "BigModulus.hh"
+
+BigModulus::BigModulus(const BigUnsigned &m) : modulus(m), special(false), k(0) {
+	if (m.isZero())
+		throw "BigModulus::BigModulus(const BigUnsigned &): division by zero";
+	/* m has the special form if 2^k - m fits in a single block, where k is
+	 * the bit length of m.  For moduli of a single block or less an ordinary
+	 * division is just as cheap, so don't bother. */
+	Index bits = m.bitLength();
+	if (bits <= BigUnsigned::N)
+		return;
+	BigUnsigned power;
+	power.setBit(bits, true);
+	BigUnsigned diff(power - m);
+	if (diff.getLength() <= 1)
+		initSpecial(bits, diff.getBlock(0));
+}
+
+BigModulus::BigModulus(Index k, Blk c) : special(false), k(0) {
+	if (k < 2)
+		throw "BigModulus::BigModulus(Index, Blk): The exponent must be at least 2";
+	BigUnsigned power;
+	power.setBit(k, true);
+	modulus.subtract(power, BigUnsigned(c));
+	if (modulus <= BigUnsigned(c))
+		throw "BigModulus::BigModulus(Index, Blk): c is too large for the special form";
+	initSpecial(k, c);
+}
+
+void BigModulus::initSpecial(Index k, Blk c) {
+	special = true;
+	this->k = k;
+	this->c = BigUnsigned(c);
+	BigUnsigned power;
+	power.setBit(k, true);
+	lowMask.subtract(power, BigUnsigned(1));
+}
+
+void BigModulus::reduce(BigUnsigned &x, Workspace &w) const {
+	if (!special) {
+		x.divideWithRemainder(modulus, w.quotient);
+		return;
+	}
+	/* Fold x = high * 2^k + low into high * c + low, which is congruent
+	 * modulo 2^k - c and strictly smaller as long as high is nonzero.  Each
+	 * fold removes about k - bitLength(c) bits, so a product of two reduced
+	 * numbers needs only two or three of them. */
+	while (x.bitLength() > k) {
+		w.high.bitShiftRight(x, k);
+		w.low.bitAnd(x, lowMask);
+		if (c == 1)
+			x.add(w.high, w.low);
+		else {
+			w.temp.multiply(w.high, c);
+			x.add(w.temp, w.low);
+		}
+	}
+	// Now x < 2^k < 2 * modulus, so one subtraction is enough.
+	if (x >= modulus)
+		x.subtract(x, modulus);
+}
+
+void BigModulus::multiply(BigUnsigned &x, const BigUnsigned &a, const BigUnsigned &b, Workspace &w) const {
+	w.product.multiply(a, b);
+	reduce(w.product, w);
+	// Copy rather than move, so that both arrays stay for the next call.
+	x = w.product;
+}
@@ -0,0 +1,72 @@
+#ifndef BIGMODULUS_H
+#define BIGMODULUS_H
+
+#include "BigUnsigned.hh"
+
+/* A BigModulus object is a modulus context: it holds a modulus together with
+ * whatever is needed to reduce numbers by it quickly.
+ *
+ * Moduli of the special form 2^k - c, where c fits in a single block, are
+ * reduced by folding: since 2^k == c (mod 2^k - c), the bits of x above
+ * position k can be shifted down, multiplied by c and added back onto the
+ * low k bits.  That takes a shift, a mask and one small multiplication
+ * instead of a full `divideWithRemainder'.  Mersenne primes like 2^127 - 1
+ * (c == 1) and pseudo-Mersenne primes like 2^255 - 19 have this form.
+ *
+ * The special form is detected automatically when a BigModulus is built from
+ * a BigUnsigned, or it can be declared explicitly by giving k and c.  Any
+ * other modulus is reduced the ordinary way. */
+class BigModulus {
+
+public:
+	typedef BigUnsigned::Blk Blk;
+	typedef BigUnsigned::Index Index;
+
+protected:
+	// The modulus itself
+	BigUnsigned modulus;
+	// Whether the modulus has the form 2^k - c
+	bool special;
+	// k and c of the special form, and 2^k - 1 for masking off the low bits
+	Index k;
+	BigUnsigned c, lowMask;
+
+	// Fills in k, c and lowMask for the modulus 2^k - c.
+	void initSpecial(Index k, Blk c);
+
+public:
+	/* Constructs a context for m, detecting the special form if present.
+	 * Throws if m is zero. */
+	BigModulus(const BigUnsigned &m);
+
+	/* Constructs a context for the declared modulus 2^k - c.  c must be less
+	 * than 2^(k-1) so that the modulus exceeds c. */
+	BigModulus(Index k, Blk c);
+
+	/* The temporaries of reduce and multiply.  Passing the same workspace
+	 * to repeated calls, as modexp does, keeps their arrays allocated. */
+	struct Workspace {
+		BigUnsigned product, quotient, high, low, temp;
+	};
+
+	// ACCESSORS
+	const BigUnsigned &getModulus() const { return modulus; }
+	bool isSpecialForm() const { return special; }
+
+	// Reduces x modulo the modulus in place.
+	void reduce(BigUnsigned &x) const {
+		Workspace w;
+		reduce(x, w);
+	}
+	void reduce(BigUnsigned &x, Workspace &w) const;
+
+	/* Stores (a * b) mod modulus in x.  x may be aliased with a or b, but
+	 * the product is formed in a temporary either way. */
+	void multiply(BigUnsigned &x, const BigUnsigned &a, const BigUnsigned &b) const {
+		Workspace w;
+		multiply(x, a, b, w);
+	}
+	void multiply(BigUnsigned &x, const BigUnsigned &a, const BigUnsigned &b, Workspace &w) const;
+};
+
+#endif
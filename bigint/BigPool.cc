@@ -0,0 +1,83 @@
+#include "BigPool.hh"
+#include <new>
+
+namespace {
+	// The size classes are 64 << c bytes for c < classCount, up to 64 KiB.
+	const size_t minClassBytes = 64;
+	const unsigned int classCount = 11;
+	const size_t maxListBytes = 256 * 1024;
+
+	struct FreeArray {
+		FreeArray *next;
+	};
+
+	/* The free lists of this thread.  This is plain data, which is zeroed
+	 * before any constructor runs, so the pool works for the static objects
+	 * of other files whatever the order of initialization. */
+	BIG_THREAD_LOCAL FreeArray *lists[classCount];
+	BIG_THREAD_LOCAL size_t counts[classCount];
+
+	// Set once the library is being unloaded
+	bool closed;
+
+	/* Returns the memory of the lists when the library is unloaded.  Arrays
+	 * that static objects free after that go straight back to the system. */
+	struct PoolCleanup {
+		~PoolCleanup() {
+			poolRelease();
+			closed = true;
+		}
+	};
+
+	PoolCleanup cleanup;
+
+	/* Returns the size class for an array of the given size and rounds the
+	 * size up to it, or returns classCount if the array is too large. */
+	unsigned int sizeClass(size_t &bytes) {
+		unsigned int c = 0;
+		size_t size = minClassBytes;
+		while (size < bytes && c < classCount) {
+			size <<= 1;
+			c++;
+		}
+		if (c < classCount)
+			bytes = size;
+		return c;
+	}
+}
+
+void *poolAllocate(size_t &bytes) {
+	unsigned int c = sizeClass(bytes);
+	if (c < classCount && lists[c] != NULL) {
+		FreeArray *p = lists[c];
+		lists[c] = p->next;
+		counts[c]--;
+		return p;
+	}
+	return ::operator new(bytes);
+}
+
+void poolFree(void *p, size_t bytes) {
+	if (p == NULL)
+		return;
+	unsigned int c = sizeClass(bytes);
+	if (closed || c == classCount || (counts[c] + 1) * bytes > maxListBytes) {
+		::operator delete(p);
+		return;
+	}
+	FreeArray *f = static_cast<FreeArray *>(p);
+	f->next = lists[c];
+	lists[c] = f;
+	counts[c]++;
+}
+
+void poolRelease() {
+	for (unsigned int c = 0; c < classCount; c++) {
+		while (lists[c] != NULL) {
+			FreeArray *next = lists[c]->next;
+			::operator delete(lists[c]);
+			lists[c] = next;
+		}
+		counts[c] = 0;
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef BIGPOOL_H
+#define BIGPOOL_H
+
+#include <cstddef>
+
+// Plain thread-local variables work with every compiler we build with.
+#ifdef _MSC_VER
+	#define BIG_THREAD_LOCAL __declspec(thread)
+#else
+	#define BIG_THREAD_LOCAL __thread
+#endif
+
+/* A size-class pool for the heap arrays of the library.  Requests are rounded
+ * up to a power of two of at least 64 bytes, and freed arrays of up to 64 KiB
+ * are kept on a free list per size class for the next request of that class,
+ * so the churn of temporaries neither calls the system allocator nor
+ * fragments the heap.  Each list holds at most 256 KiB; larger arrays, and
+ * arrays freed to a full list, go back to the system.
+ *
+ * Arrays must be freed with their size, as there is no header to store it
+ * in.  Each thread has its own lists, so no locking is needed; an array
+ * freed by another thread than the one that allocated it simply joins the
+ * lists of the freeing thread. */
+
+/* Returns an array of at least bytes bytes.  bytes receives the size that
+ * was actually granted. */
+void *poolAllocate(size_t &bytes);
+
+// Frees an array, given the size that was requested or granted for it.
+void poolFree(void *p, size_t bytes);
+
+/* Returns the arrays on the calling thread's lists to the system.  The lists
+ * of the thread that unloads the library are emptied automatically; other
+ * threads should call this before they exit. */
+void poolRelease();
+
+/* Gets an uninitialized array of at least count elements of a trivial type
+ * from the pool; count receives the number that fit. */
+template <class T>
+T *poolNewArray(size_t &count) {
+	size_t bytes = count * sizeof(T);
+	T *p = static_cast<T *>(poolAllocate(bytes));
+	count = bytes / sizeof(T);
+	return p;
+}
+
+// Returns an array of count elements, as granted by poolNewArray.
+template <class T>
+void poolDeleteArray(T *p, size_t count) {
+	poolFree(p, count * sizeof(T));
+}
+
+#endif
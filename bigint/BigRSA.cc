@@ -0,0 +1,368 @@
+#include "BigRSA.hh"
+#include "BigIntegerUtils.hh"
+#include <cstring>
+#include <random>
+
+BigUnsigned rsaPublic(const BigUnsigned &base, const BigUnsigned &exponent,
+		const BigModulus &modulus) {
+	// Check for exponent == 2^t + 1 with t > 0.
+	BigUnsigned::Index t = exponent.bitLength();
+	if (t < 2 || !exponent.getBit(0))
+		return modexp(base, exponent, modulus);
+	t--;
+	for (BigUnsigned::Index i = 1; i < t; i++)
+		if (exponent.getBit(i))
+			return modexp(base, exponent, modulus);
+
+	BigUnsigned ans(base);
+	modulus.reduce(ans);
+	BigUnsigned base2(ans);
+	BigModulus::Workspace w;
+	for (BigUnsigned::Index i = 0; i < t; i++)
+		modulus.multiply(ans, ans, ans, w);
+	modulus.multiply(ans, ans, base2, w);
+	return ans;
+}
+
+namespace {
+	// SHA-256 (FIPS 180-4), needed by EMSA-PSS for M' and MGF1.
+	class SHA256 {
+		unsigned int h[8];
+		unsigned char buffer[64];
+		unsigned int bufferLength;
+		unsigned long long totalLength;
+
+		static unsigned int rotr(unsigned int x, unsigned int n) {
+			return (x >> n) | (x << (32 - n));
+		}
+
+		void block(const unsigned char *p) {
+			static const unsigned int k[64] = {
+				0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+				0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+				0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+				0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+				0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+				0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+				0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+				0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+			};
+			unsigned int w[64], a[8];
+			int i;
+			for (i = 0; i < 16; i++)
+				w[i] = (unsigned int)(p[4 * i]) << 24 | (unsigned int)(p[4 * i + 1]) << 16
+					| (unsigned int)(p[4 * i + 2]) << 8 | p[4 * i + 3];
+			for (; i < 64; i++)
+				w[i] = w[i - 16] + (rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3))
+					+ w[i - 7] + (rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10));
+			for (i = 0; i < 8; i++)
+				a[i] = h[i];
+			for (i = 0; i < 64; i++) {
+				unsigned int t1 = a[7] + (rotr(a[4], 6) ^ rotr(a[4], 11) ^ rotr(a[4], 25))
+					+ ((a[4] & a[5]) ^ (~a[4] & a[6])) + k[i] + w[i];
+				unsigned int t2 = (rotr(a[0], 2) ^ rotr(a[0], 13) ^ rotr(a[0], 22))
+					+ ((a[0] & a[1]) ^ (a[0] & a[2]) ^ (a[1] & a[2]));
+				a[7] = a[6]; a[6] = a[5]; a[5] = a[4]; a[4] = a[3] + t1;
+				a[3] = a[2]; a[2] = a[1]; a[1] = a[0]; a[0] = t1 + t2;
+			}
+			for (i = 0; i < 8; i++)
+				h[i] += a[i];
+		}
+
+	public:
+		static const unsigned int size = 32;
+
+		SHA256() : bufferLength(0), totalLength(0) {
+			static const unsigned int init[8] = {
+				0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+			};
+			for (int i = 0; i < 8; i++)
+				h[i] = init[i];
+		}
+
+		void update(const unsigned char *data, unsigned int length) {
+			totalLength += length;
+			while (length > 0) {
+				unsigned int n = 64 - bufferLength;
+				if (n > length)
+					n = length;
+				memcpy(buffer + bufferLength, data, n);
+				bufferLength += n;
+				data += n;
+				length -= n;
+				if (bufferLength == 64) {
+					block(buffer);
+					bufferLength = 0;
+				}
+			}
+		}
+
+		void final(unsigned char *out) {
+			unsigned long long bits = totalLength * 8;
+			unsigned char pad = 0x80;
+			update(&pad, 1);
+			pad = 0;
+			while (bufferLength != 56)
+				update(&pad, 1);
+			unsigned char length[8];
+			for (int i = 0; i < 8; i++)
+				length[i] = (unsigned char)(bits >> (56 - 8 * i));
+			update(length, 8);
+			for (int i = 0; i < 8; i++) {
+				out[4 * i] = (unsigned char)(h[i] >> 24);
+				out[4 * i + 1] = (unsigned char)(h[i] >> 16);
+				out[4 * i + 2] = (unsigned char)(h[i] >> 8);
+				out[4 * i + 3] = (unsigned char)h[i];
+			}
+		}
+	};
+
+	// ASN.1 DigestInfo prefixes for EMSA-PKCS1-v1_5 (RFC 8017, section 9.2).
+	struct DigestInfoPrefix {
+		unsigned int digestLength;
+		unsigned char prefix[19];
+	};
+	const DigestInfoPrefix digestInfoPrefixes[] = {
+		{ 16, { 0x30, 0x20, 0x30, 0x0c, 0x06, 0x08, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x02, 0x05, 0x05, 0x00, 0x04, 0x10 } },
+		{ 20, { 0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2b, 0x0e, 0x03, 0x02, 0x1a, 0x05, 0x00, 0x04, 0x14 } },
+		{ 28, { 0x30, 0x2d, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, 0x05, 0x00, 0x04, 0x1c } },
+		{ 32, { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20 } },
+		{ 48, { 0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30 } },
+		{ 64, { 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40 } }
+	};
+
+	// EMSA-PKCS1-v1_5: EM == 00 01 FF..FF 00 || DigestInfo prefix || digest.
+	bool checkPKCS1v15(const unsigned char *em, unsigned int emLength,
+			const unsigned char *digest, unsigned int digestLength) {
+		const DigestInfoPrefix *info = NULL;
+		for (unsigned int i = 0; i < sizeof(digestInfoPrefixes) / sizeof(digestInfoPrefixes[0]); i++)
+			if (digestInfoPrefixes[i].digestLength == digestLength)
+				info = &digestInfoPrefixes[i];
+		if (info == NULL)
+			throw "rsaVerify: Unsupported digest length for PKCS#1 v1.5";
+		unsigned int prefixLength = (digestLength == 20) ? 15 : (digestLength == 16) ? 18 : 19;
+		unsigned int tLength = prefixLength + digestLength;
+		// At least eight bytes of 0xFF padding are required.
+		if (emLength < tLength + 11)
+			return false;
+		unsigned int psEnd = emLength - tLength - 1;
+		// Accumulate differences instead of returning early.
+		unsigned char diff = em[0] | (em[1] ^ 0x01) | em[psEnd];
+		for (unsigned int i = 2; i < psEnd; i++)
+			diff |= em[i] ^ 0xFF;
+		for (unsigned int i = 0; i < prefixLength; i++)
+			diff |= em[psEnd + 1 + i] ^ info->prefix[i];
+		for (unsigned int i = 0; i < digestLength; i++)
+			diff |= em[psEnd + 1 + prefixLength + i] ^ digest[i];
+		return diff == 0;
+	}
+
+	// EMSA-PSS-VERIFY (RFC 8017, section 9.1.2) with SHA-256.
+	bool checkPSS(const unsigned char *em, unsigned int emLength, unsigned int emBits,
+			const unsigned char *digest, unsigned int digestLength) {
+		const unsigned int hLength = SHA256::size;
+		if (digestLength != hLength)
+			throw "rsaVerify: PSS requires a 32-byte SHA-256 digest";
+		if (emLength < hLength + 2 || em[emLength - 1] != 0xbc)
+			return false;
+		unsigned int dbLength = emLength - hLength - 1;
+		const unsigned char *h = em + dbLength;
+		unsigned char topMask = (unsigned char)(0xFF >> (8 * emLength - emBits));
+		if (em[0] & ~topMask)
+			return false;
+
+		// DB = maskedDB xor MGF1(H, dbLength)
+		unsigned char *db = new unsigned char[dbLength];
+		unsigned char mask[SHA256::size];
+		for (unsigned int counter = 0, done = 0; done < dbLength; counter++) {
+			unsigned char c[4] = { (unsigned char)(counter >> 24), (unsigned char)(counter >> 16),
+				(unsigned char)(counter >> 8), (unsigned char)counter };
+			SHA256 mgf;
+			mgf.update(h, hLength);
+			mgf.update(c, 4);
+			mgf.final(mask);
+			for (unsigned int i = 0; i < hLength && done < dbLength; i++, done++)
+				db[done] = em[done] ^ mask[i];
+		}
+		db[0] &= topMask;
+
+		// DB == 00..00 01 || salt
+		unsigned int saltStart = 0;
+		while (saltStart < dbLength && db[saltStart] == 0)
+			saltStart++;
+		bool valid = (saltStart < dbLength && db[saltStart] == 0x01);
+		if (valid) {
+			saltStart++;
+			// H == Hash(00 00 00 00 00 00 00 00 || digest || salt)
+			unsigned char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }, h2[SHA256::size];
+			SHA256 hash;
+			hash.update(zeros, 8);
+			hash.update(digest, digestLength);
+			hash.update(db + saltStart, dbLength - saltStart);
+			hash.final(h2);
+			valid = (memcmp(h, h2, hLength) == 0);
+		}
+		delete [] db;
+		return valid;
+	}
+}
+
+bool rsaVerify(const BigUnsigned &n, const BigUnsigned &e,
+		const unsigned char *signature, unsigned int signatureLength,
+		const unsigned char *digest, unsigned int digestLength,
+		RSAScheme scheme) {
+	unsigned int modBits = n.bitLength();
+	unsigned int k = (modBits + 7) / 8;
+	// The signature must be exactly as long as the modulus (RFC 8017, 8.2.2).
+	if (modBits < 2 || signatureLength != k)
+		return false;
+
+	// The signature bytes are packed straight into blocks.
+	BigUnsigned s(bytesToBigUnsigned(signature, signatureLength));
+	if (s >= n)
+		return false;
+	BigUnsigned m(rsaPublic(s, e, BigModulus(n)));
+
+	bool valid;
+	if (scheme == rsaPKCS1v15) {
+		unsigned char *em = new unsigned char[k];
+		bigUnsignedToBytes(m, em, k);
+		try {
+			valid = checkPKCS1v15(em, k, digest, digestLength);
+		} catch (...) {
+			delete [] em;
+			throw;
+		}
+		delete [] em;
+	} else if (scheme == rsaPSS) {
+		// The encoded message has modBits - 1 bits.
+		unsigned int emBits = modBits - 1, emLength = (emBits + 7) / 8;
+		unsigned char *em = new unsigned char[emLength];
+		if (!bigUnsignedToBytes(m, em, emLength)) {
+			delete [] em;
+			return false;
+		}
+		try {
+			valid = checkPSS(em, emLength, emBits, digest, digestLength);
+		} catch (...) {
+			delete [] em;
+			throw;
+		}
+		delete [] em;
+	} else
+		throw "rsaVerify: Unknown signature scheme";
+	return valid;
+}
+
+namespace {
+	// Sets x to a number of at most `bits' random bits.
+	void randomBits(BigUnsigned &x, BigUnsigned::Index bits, std::random_device &rng) {
+		x = BigUnsigned();
+		for (BigUnsigned::Index i = 0; i < bits; i += 32) {
+			unsigned int r = rng();
+			for (BigUnsigned::Index j = 0; j < 32 && i + j < bits; j++)
+				if ((r >> j) & 1)
+					x.setBit(i + j, true);
+		}
+	}
+
+	// The odd primes below 2048, for sieving prime candidates.
+	const unsigned int numSievePrimes = 308;
+	const unsigned short *sievePrimes() {
+		static unsigned short primes[numSievePrimes];
+		static bool initialized = false;
+		if (!initialized) {
+			unsigned int count = 0;
+			for (unsigned short c = 3; count < numSievePrimes; c += 2) {
+				bool prime = true;
+				for (unsigned int i = 0; i < count && primes[i] * primes[i] <= c; i++)
+					if (c % primes[i] == 0) {
+						prime = false;
+						break;
+					}
+				if (prime)
+					primes[count++] = c;
+			}
+			initialized = true;
+		}
+		return primes;
+	}
+
+	/* Returns a random prime of exactly `bits' bits whose top two bits are
+	 * set, so that the product of two of them has exactly the sum of their
+	 * bit lengths, and for which p - 1 is coprime to e.  The residues of a
+	 * random odd start modulo the sieve primes are computed once, and then
+	 * the candidates start + delta are sieved with single-word arithmetic. */
+	BigUnsigned generatePrime(BigUnsigned::Index bits, const BigUnsigned &e,
+			std::random_device &rng) {
+		const unsigned short *primes = sievePrimes();
+		const unsigned int sieveRange = 1 << 16;
+		// Miller-Rabin rounds after FIPS 186-4, Table C.2
+		unsigned int rounds = bits >= 1536 ? 4 : bits >= 1024 ? 5 : bits >= 512 ? 7 : 40;
+
+		unsigned int residues[numSievePrimes];
+		for (;;) {
+			BigUnsigned start;
+			randomBits(start, bits, rng);
+			start.setBit(bits - 1, true);
+			start.setBit(bits - 2, true);
+			start.setBit(0, true);
+			for (unsigned int i = 0; i < numSievePrimes; i++)
+				residues[i] = (start % BigUnsigned(primes[i])).toUnsignedInt();
+
+			for (unsigned int delta = 0; delta < sieveRange; delta += 2) {
+				unsigned int i;
+				for (i = 0; i < numSievePrimes; i++)
+					if ((residues[i] + delta) % primes[i] == 0)
+						break;
+				if (i < numSievePrimes)
+					continue;
+
+				BigUnsigned candidate(start + BigUnsigned(delta));
+				if (candidate.bitLength() != bits)
+					break;
+				BigUnsigned candidateMinus1(candidate);
+				candidateMinus1--;
+				if (gcd(candidateMinus1, e) != BigUnsigned(1))
+					continue;
+				if (isProbablePrime(candidate, rounds))
+					return candidate;
+			}
+		}
+	}
+}
+
+void rsaGenerate(RSAKey &key, unsigned int bits, const BigUnsigned &e) {
+	if (bits < 64)
+		throw "rsaGenerate: The modulus must have at least 64 bits";
+	if (e < BigUnsigned(3) || !e.getBit(0))
+		throw "rsaGenerate: The public exponent must be odd and at least 3";
+
+	std::random_device rng;
+	BigUnsigned::Index pBits = (bits + 1) / 2, qBits = bits - pBits;
+	for (;;) {
+		key.p = generatePrime(pBits, e, rng);
+		key.q = generatePrime(qBits, e, rng);
+		if (key.p < key.q) {
+			BigUnsigned temp(key.p);
+			key.p = key.q;
+			key.q = temp;
+		}
+		// Fermat factoring finds p and q quickly if they are too close.
+		BigUnsigned diff(key.p - key.q);
+		if (pBits > 100 ? diff.bitLength() > pBits - 100 : !diff.isZero())
+			break;
+	}
+
+	BigUnsigned pMinus1(key.p), qMinus1(key.q);
+	pMinus1--;
+	qMinus1--;
+	BigUnsigned lambda(pMinus1 / gcd(pMinus1, qMinus1) * qMinus1);
+
+	key.n = key.p * key.q;
+	key.e = e;
+	key.d = modinv(e, lambda);
+	key.dp = key.d % pMinus1;
+	key.dq = key.d % qMinus1;
+	key.qinv = modinv(key.q, key.p);
+}
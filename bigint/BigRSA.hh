@@ -0,0 +1,53 @@
+#ifndef BIGRSA_H
+#define BIGRSA_H
+
+#include "BigIntegerAlgorithms.hh"
+
+/* RSA signature verification and key generation on BigUnsigneds.  Keys and
+ * signatures are plain numbers and big-endian byte strings; hashing the
+ * message is up to the caller, except for the SHA-256 that PSS needs
+ * internally.  Verification returns false for any malformed signature and
+ * throws only for unsupported parameters. */
+
+// Signature encoding schemes understood by rsaVerify.
+enum RSAScheme {
+	/* EMSA-PKCS1-v1_5.  The hash function is identified by the digest
+	 * length: 16 (MD5), 20 (SHA-1), 28 (SHA-224), 32 (SHA-256),
+	 * 48 (SHA-384) or 64 (SHA-512) bytes. */
+	rsaPKCS1v15 = 0,
+	/* EMSA-PSS with SHA-256 and MGF1-SHA-256.  The digest must be a
+	 * 32-byte SHA-256 hash; any salt length is accepted. */
+	rsaPSS = 1
+};
+
+/* Returns (base ^ exponent) % modulus for a public exponent.  Exponents of the
+ * form 2^t + 1, like 65537, take t squarings and a single multiplication;
+ * anything else goes to modexp. */
+BigUnsigned rsaPublic(const BigUnsigned &base, const BigUnsigned &exponent,
+		const BigModulus &modulus);
+
+/* Verifies the RSA signature `signature' (a big-endian byte string of
+ * `signatureLength' bytes) on the message digest `digest' with the public key
+ * (n, e).  A signature that is not exactly as long as n in bytes is invalid.
+ * Throws if the scheme or digest length is not supported. */
+bool rsaVerify(const BigUnsigned &n, const BigUnsigned &e,
+		const unsigned char *signature, unsigned int signatureLength,
+		const unsigned char *digest, unsigned int digestLength,
+		RSAScheme scheme);
+
+// An RSA private key together with its CRT parameters.
+struct RSAKey {
+	// Modulus n = p * q with p > q, public exponent e, private exponent d
+	BigUnsigned n, e, d, p, q;
+	// d % (p - 1), d % (q - 1) and the inverse of q modulo p
+	BigUnsigned dp, dq, qinv;
+};
+
+/* Generates an RSA key whose modulus has exactly `bits' bits (at least 64)
+ * with the public exponent e, which must be odd and at least 3.  Prime
+ * candidates are sieved by the primes below 2048 before Miller-Rabin, and d
+ * is the inverse of e modulo lcm(p - 1, q - 1).  Randomness comes from
+ * std::random_device. */
+void rsaGenerate(RSAKey &key, unsigned int bits, const BigUnsigned &e);
+
+#endif
@@ -0,0 +1,202 @@
+#include "BigRadix.hh"
+
+namespace {
+	typedef BigUnsigned::Blk Blk;
+	typedef BigUnsigned::Index Index;
+
+	/* Numbers up to this many blocks are converted a chunk at a time;
+	 * splitting them further costs more than it saves. */
+	const Index splitThreshold = 40;
+
+	/* The powers P_k = b^(d * 2^k) of one base, each standing for 2^k
+	 * chunks, with what Barrett reduction needs to divide by them: the bit
+	 * length n_k of P_k and the reciprocal floor(2^(2 n_k) / P_k), which is
+	 * zero until first needed. */
+	class RadixPowers {
+		Index levels, capacity;
+		BigUnsigned *powers, *reciprocals;
+		Index *bits;
+
+	public:
+		unsigned int base;
+		Blk chunkPower;
+		unsigned int chunkDigits;
+		RadixPowers *next;
+
+		RadixPowers(unsigned int base) : levels(0), capacity(0),
+				powers(NULL), reciprocals(NULL), bits(NULL), base(base), next(NULL) {
+			radixChunk(base, chunkPower, chunkDigits);
+		}
+
+		~RadixPowers() {
+			delete [] powers;
+			delete [] reciprocals;
+			delete [] bits;
+		}
+
+		// Makes sure that P_k is available.
+		void extend(Index k) {
+			if (k < levels)
+				return;
+			if (k >= capacity) {
+				Index newCapacity = k + 8;
+				BigUnsigned *newPowers = new BigUnsigned[newCapacity];
+				BigUnsigned *newReciprocals = new BigUnsigned[newCapacity];
+				Index *newBits = new Index[newCapacity];
+				for (Index i = 0; i < levels; i++) {
+					newPowers[i] = powers[i];
+					newReciprocals[i] = reciprocals[i];
+					newBits[i] = bits[i];
+				}
+				delete [] powers;
+				delete [] reciprocals;
+				delete [] bits;
+				powers = newPowers;
+				reciprocals = newReciprocals;
+				bits = newBits;
+				capacity = newCapacity;
+			}
+			for (; levels <= k; levels++) {
+				if (levels == 0)
+					powers[0] = BigUnsigned(chunkPower);
+				else
+					powers[levels].multiply(powers[levels - 1], powers[levels - 1]);
+				bits[levels] = powers[levels].bitLength();
+			}
+		}
+
+		const BigUnsigned &getPower(Index k) {
+			extend(k);
+			return powers[k];
+		}
+
+		Index getBits(Index k) {
+			extend(k);
+			return bits[k];
+		}
+
+		/* Sets q = x / P_k and r = x % P_k for x < P_k^2 by Barrett
+		 * reduction: the estimate ((x >> (n - 1)) * reciprocal) >> (n + 1)
+		 * is at most two too small. */
+		void divide(const BigUnsigned &x, Index k, BigUnsigned &q, BigUnsigned &r) {
+			extend(k);
+			Index n = bits[k];
+			BigUnsigned temp;
+			// Only conversion to chunks needs the reciprocals; make them on demand.
+			if (reciprocals[k].isZero()) {
+				temp.setBit(2 * n, true);
+				temp.divideWithRemainder(powers[k], reciprocals[k]);
+			}
+			temp.bitShiftRight(x, n - 1);
+			q.multiply(temp, reciprocals[k]);
+			q.bitShiftRight(q, n + 1);
+			temp.multiply(q, powers[k]);
+			r.subtract(x, temp);
+			while (r >= powers[k]) {
+				r.subtract(r, powers[k]);
+				q++;
+			}
+		}
+	};
+
+	// Powers are computed on first use and kept until the library is unloaded.
+	class RadixPowersCache {
+		RadixPowers *first;
+
+	public:
+		RadixPowersCache() : first(NULL) {}
+
+		~RadixPowersCache() {
+			while (first != NULL) {
+				RadixPowers *next = first->next;
+				delete first;
+				first = next;
+			}
+		}
+
+		RadixPowers &get(unsigned int base) {
+			for (RadixPowers *p = first; p != NULL; p = p->next)
+				if (p->base == base)
+					return *p;
+			RadixPowers *p = new RadixPowers(base);
+			p->next = first;
+			first = p;
+			return *p;
+		}
+	};
+
+	RadixPowersCache powersCache;
+
+	/* Writes x, which must be less than P_(k+1), as exactly 2^(k+1) chunks
+	 * to out. */
+	void toChunks(const BigUnsigned &x, RadixPowers &powers, Index k, Blk *out) {
+		Index width = Index(1) << (k + 1);
+		if (x.getLength() <= splitThreshold) {
+			BigUnsigned x2(x);
+			for (Index i = 0; i < width; i++)
+				out[i] = x2.isZero() ? 0 : x2.divideBlock(powers.chunkPower);
+			return;
+		}
+		BigUnsigned high, low;
+		powers.divide(x, k, high, low);
+		toChunks(low, powers, k - 1, out);
+		toChunks(high, powers, k - 1, out + width / 2);
+	}
+
+	BigUnsigned fromChunks(const Blk *chunks, Index count, RadixPowers &powers) {
+		if (count <= splitThreshold) {
+			BigUnsigned ans;
+			for (Index i = count; i > 0; i--)
+				ans.multiplyAddBlock(powers.chunkPower, chunks[i - 1]);
+			return ans;
+		}
+		// Split off the largest power-of-two number of chunks below count.
+		Index k = 0;
+		while ((Index(2) << k) < count)
+			k++;
+		Index half = Index(1) << k;
+		BigUnsigned ans;
+		ans.multiply(fromChunks(chunks + half, count - half, powers), powers.getPower(k));
+		ans.add(ans, fromChunks(chunks, half, powers));
+		return ans;
+	}
+}
+
+void radixChunk(unsigned int base, Blk &power, unsigned int &digits) {
+	power = 1;
+	digits = 0;
+	while (power <= ~Blk(0) / base) {
+		power *= base;
+		digits++;
+	}
+}
+
+Blk *bigUnsignedToChunks(const BigUnsigned &x, unsigned int base, Index &count) {
+	RadixPowers &powers = powersCache.get(base);
+	Blk *chunks;
+	if (x.getLength() <= splitThreshold) {
+		/* For bases up to 65535 a chunk power is at least 2^(N / 2) - 1,
+		 * so two chunks per block, plus one, are enough. */
+		chunks = new Blk[2 * x.getLength() + 1];
+		BigUnsigned x2(x);
+		count = 0;
+		while (!x2.isZero())
+			chunks[count++] = x2.divideBlock(powers.chunkPower);
+		return chunks;
+	}
+	/* Find the first k with x < P_(k+1) = P_k^2.  Since P_k >= 2^(n_k - 1),
+	 * that holds if x has at most 2 (n_k - 1) bits. */
+	Index k = 0;
+	while (x.bitLength() > 2 * (powers.getBits(k) - 1))
+		k++;
+	count = Index(1) << (k + 1);
+	chunks = new Blk[count];
+	toChunks(x, powers, k, chunks);
+	while (count > 0 && chunks[count - 1] == 0)
+		count--;
+	return chunks;
+}
+
+BigUnsigned chunksToBigUnsigned(const Blk *chunks, Index count, unsigned int base) {
+	return fromChunks(chunks, count, powersCache.get(base));
+}
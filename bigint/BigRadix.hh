@@ -0,0 +1,35 @@
+#ifndef BIGRADIX_H
+#define BIGRADIX_H
+
+#include "BigUnsigned.hh"
+
+/* Radix conversion a chunk of digits at a time, shared by BigUnsignedInABase
+ * and the decimal string routines in BigIntegerUtils.
+ *
+ * A chunk is a block holding as many digits of the base as fit, i.e. a digit
+ * of the base b^d, where b^d is the largest power of b that fits in a block.
+ * Small numbers are converted with single-block divisions and multiply-adds.
+ * Large ones are split recursively by b^(d * 2^k), and both halves are
+ * converted on their own, which makes the conversion about as fast as the
+ * multiplication.  The powers b^(d * 2^k), along with reciprocals for
+ * dividing by them, are cached per base and shared across calls.
+ *
+ * The cache is filled on first use without locking, so conversions must not
+ * run on several threads at once. */
+
+/* Returns the largest power of base (at least 2) that fits in a block and
+ * its number of digits. */
+void radixChunk(unsigned int base, BigUnsigned::Blk &power, unsigned int &digits);
+
+/* Splits x into chunks, least significant first, and returns them in a
+ * new[]-allocated array that the caller deletes.  count receives the number
+ * of chunks, which is zero if x is zero; otherwise the last chunk is
+ * nonzero. */
+BigUnsigned::Blk *bigUnsignedToChunks(const BigUnsigned &x, unsigned int base,
+		BigUnsigned::Index &count);
+
+// Assembles the number from count chunks, least significant first.
+BigUnsigned chunksToBigUnsigned(const BigUnsigned::Blk *chunks,
+		BigUnsigned::Index count, unsigned int base);
+
+#endif
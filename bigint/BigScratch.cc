@@ -0,0 +1,85 @@
+#include "BigScratch.hh"
+#include <new>
+
+namespace {
+	typedef BigUnsigned::Blk Blk;
+
+	// The first chunk holds 4 KiB of blocks.
+	const size_t firstChunkBlocks = 4096 / sizeof(Blk);
+
+	// A chunk header, followed by its blocks
+	struct Chunk {
+		Chunk *next;
+		size_t capacity;
+		size_t used;
+
+		Blk *blocks() {
+			return reinterpret_cast<Blk *>(this + 1);
+		}
+	};
+
+	/* The chunks of this thread, and the chunk that the next block comes
+	 * from.  Chunks after the current one are unused. */
+	BIG_THREAD_LOCAL Chunk *first;
+	BIG_THREAD_LOCAL Chunk *current;
+
+	// Frees chunk and all chunks after it.
+	void freeChunks(Chunk *chunk) {
+		while (chunk != NULL) {
+			Chunk *next = chunk->next;
+			::operator delete(chunk);
+			chunk = next;
+		}
+	}
+}
+
+BigScratchFrame::BigScratchFrame() : chunk(current), used(current != NULL ? current->used : 0) {}
+
+BigScratchFrame::~BigScratchFrame() {
+	Chunk *c = static_cast<Chunk *>(chunk);
+	// If the arena was empty, the frame's blocks start at the first chunk.
+	if (c == NULL)
+		c = first;
+	current = c;
+	if (c != NULL)
+		c->used = used;
+}
+
+BigUnsigned::Blk *BigScratchFrame::take(size_t count) {
+	Chunk *c = current;
+	if (c != NULL && c->capacity - c->used >= count) {
+		Blk *p = c->blocks() + c->used;
+		c->used += count;
+		return p;
+	}
+	// Move on to the next chunk, replacing it with a larger one if needed.
+	Chunk *next = (c != NULL) ? c->next : first;
+	if (next == NULL || next->capacity < count) {
+		size_t capacity = (c != NULL) ? 2 * c->capacity : firstChunkBlocks;
+		if (capacity < count)
+			capacity = count;
+		freeChunks(next);
+		next = static_cast<Chunk *>(::operator new(sizeof(Chunk) + capacity * sizeof(Blk)));
+		next->next = NULL;
+		next->capacity = capacity;
+		if (c != NULL)
+			c->next = next;
+		else
+			first = next;
+	}
+	next->used = count;
+	current = next;
+	return next->blocks();
+}
+
+void scratchRelease() {
+	if (current == NULL)
+		return;
+	freeChunks(current->next);
+	current->next = NULL;
+	// The first chunk is free too if no frame has borrowed from it.
+	if (current == first && first->used == 0) {
+		::operator delete(first);
+		first = current = NULL;
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef BIGSCRATCH_H
+#define BIGSCRATCH_H
+
+#include <cstddef>
+#include "BigUnsigned.hh"
+
+/* A per-thread scratch arena for the temporary block arrays of the core
+ * algorithms.  A BigScratchFrame borrows arrays from the arena of its thread
+ * and gives all of them back when it goes out of scope, so frames nest like
+ * the calls that open them, exceptions included.
+ *
+ * The arena grows in chunks, each at least twice as large as the one before,
+ * and keeps them until scratchRelease is called.  After the first few calls,
+ * the inner loops of division, multiplication and radix conversion borrow
+ * their temporaries without touching the allocator. */
+
+class BigScratchFrame {
+	// Where the arena stood when the frame was opened
+	void *chunk;
+	size_t used;
+
+	// Frames are not copyable.
+	BigScratchFrame(const BigScratchFrame &);
+	void operator =(const BigScratchFrame &);
+
+public:
+	BigScratchFrame();
+	~BigScratchFrame();
+
+	/* Returns an uninitialized array of count blocks, which stays valid
+	 * until this frame goes out of scope. */
+	BigUnsigned::Blk *take(size_t count);
+};
+
+/* Frees the chunks of the calling thread's arena that no open frame uses; with
+ * no frame open, that is all of them. */
+void scratchRelease();
+
+#endif
@@ -1,23 +1,33 @@
 #include "BigUnsigned.hh"
+#include "BigScratch.hh"
+
+// The double-width type is chosen in BigUnsigned.hh.
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	typedef BigUnsignedDoubleBlk DoubleBlk;
+#endif
 
 // Memory management definitions have moved to the bottom of NumberlikeArray.hh.
 
 // The templates used by these constructors and converters are at the bottom of
 // BigUnsigned.hh.
 
-BigUnsigned::BigUnsigned(unsigned long  x) { initFromPrimitive      (x); }
-BigUnsigned::BigUnsigned(unsigned int   x) { initFromPrimitive      (x); }
-BigUnsigned::BigUnsigned(unsigned short x) { initFromPrimitive      (x); }
-BigUnsigned::BigUnsigned(         long  x) { initFromSignedPrimitive(x); }
-BigUnsigned::BigUnsigned(         int   x) { initFromSignedPrimitive(x); }
-BigUnsigned::BigUnsigned(         short x) { initFromSignedPrimitive(x); }
-
-unsigned long  BigUnsigned::toUnsignedLong () const { return convertToPrimitive      <unsigned long >(); }
-unsigned int   BigUnsigned::toUnsignedInt  () const { return convertToPrimitive      <unsigned int  >(); }
-unsigned short BigUnsigned::toUnsignedShort() const { return convertToPrimitive      <unsigned short>(); }
-long           BigUnsigned::toLong         () const { return convertToSignedPrimitive<         long >(); }
-int            BigUnsigned::toInt          () const { return convertToSignedPrimitive<         int  >(); }
-short          BigUnsigned::toShort        () const { return convertToSignedPrimitive<         short>(); }
+BigUnsigned::BigUnsigned(unsigned long long x) { initFromPrimitive      (x); }
+BigUnsigned::BigUnsigned(unsigned long      x) { initFromPrimitive      (x); }
+BigUnsigned::BigUnsigned(unsigned int       x) { initFromPrimitive      (x); }
+BigUnsigned::BigUnsigned(unsigned short     x) { initFromPrimitive      (x); }
+BigUnsigned::BigUnsigned(         long long x) { initFromSignedPrimitive(x); }
+BigUnsigned::BigUnsigned(         long      x) { initFromSignedPrimitive(x); }
+BigUnsigned::BigUnsigned(         int       x) { initFromSignedPrimitive(x); }
+BigUnsigned::BigUnsigned(         short     x) { initFromSignedPrimitive(x); }
+
+unsigned long long BigUnsigned::toUnsignedLongLong() const { return convertToPrimitive      <unsigned long long>(); }
+unsigned long      BigUnsigned::toUnsignedLong    () const { return convertToPrimitive      <unsigned long     >(); }
+unsigned int       BigUnsigned::toUnsignedInt     () const { return convertToPrimitive      <unsigned int      >(); }
+unsigned short     BigUnsigned::toUnsignedShort   () const { return convertToPrimitive      <unsigned short    >(); }
+long long          BigUnsigned::toLongLong        () const { return convertToSignedPrimitive<         long long>(); }
+long               BigUnsigned::toLong            () const { return convertToSignedPrimitive<         long     >(); }
+int                BigUnsigned::toInt             () const { return convertToSignedPrimitive<         int      >(); }
+short              BigUnsigned::toShort           () const { return convertToSignedPrimitive<         short    >(); }
 
 // BIT/BLOCK ACCESSORS
 
@@ -96,33 +106,19 @@ BigUnsigned::CmpRes BigUnsigned::compareTo(const BigUnsigned &x) const {
  * little and write the outputs little by little.  However, if one of the
  * inputs is coming from the same variable into which the output is to be
  * stored (an "aliased" call), we risk overwriting the input before we read it.
- * In this case, we first compute the result into a temporary BigUnsigned
- * variable and then copy it into the requested output variable *this.
- * Each put-here operation uses the DTRT_ALIASED macro (Do The Right Thing on
- * aliased calls) to generate code for this check.
- * 
- * I adopted this approach on 2007.02.13 (see Assignment Operators in
- * BigUnsigned.hh).  Before then, put-here operations rejected aliased calls
- * with an exception.  I think doing the right thing is better.
- * 
- * Some of the put-here operations can probably handle aliased calls safely
- * without the extra copy because (for example) they process blocks strictly
- * right-to-left.  At some point I might determine which ones don't need the
- * copy, but my reasoning would need to be verified very carefully.  For now
- * I'll leave in the copy.
+ *
+ * Each operation handles aliasing itself, without copying the inputs:
+ *
+ * - add, subtract and the bitwise operations read block i of each input
+ *   before writing block i of the output, so they work in place as long as
+ *   the lengths are read up front and growing keeps the existing blocks.
+ * - A left shift writes from the top down and a right shift from the bottom
+ *   up, so each block is read before it is overwritten.
+ * - multiply can't work in place at all; an aliased call multiplies into a
+ *   fresh BigUnsigned, whose array is then moved into *this, not copied.
  */
-#define DTRT_ALIASED(cond, op) \
-	if (cond) { \
-		BigUnsigned tmpThis; \
-		tmpThis.op; \
-		*this = tmpThis; \
-		return; \
-	}
-
-
 
 void BigUnsigned::add(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, add(a, b));
 	// If one argument is zero, copy the other.
 	if (a.len == 0) {
 		operator =(b);
@@ -145,16 +141,21 @@ void BigUnsigned::add(const BigUnsigned &a, const BigUnsigned &b) {
 		a2 = &b;
 		b2 = &a;
 	}
-	// Set prelimiary length and make room in this BigUnsigned
-	len = a2->len + 1;
-	allocate(len);
+	// Read the lengths before ours changes, in case we are an input.
+	Index aLen = a2->len, bLen = b2->len;
+	// Make room in this BigUnsigned, keeping our blocks if they are an input
+	if (this == &a || this == &b)
+		allocateAndCopy(aLen + 1);
+	else
+		allocate(aLen + 1);
+	const Blk *aBlk = a2->blk, *bBlk = b2->blk;
 	// For each block index that is present in both inputs...
-	for (i = 0, carryIn = false; i < b2->len; i++) {
+	for (i = 0, carryIn = false; i < bLen; i++) {
 		// Add input blocks
-		temp = a2->blk[i] + b2->blk[i];
+		temp = aBlk[i] + bBlk[i];
 		// If a rollover occurred, the result is less than either input.
 		// This test is used many times in the BigUnsigned code.
-		carryOut = (temp < a2->blk[i]);
+		carryOut = (temp < aBlk[i]);
 		// If a carry was input, handle it
 		if (carryIn) {
 			temp++;
@@ -165,24 +166,23 @@ void BigUnsigned::add(const BigUnsigned &a, const BigUnsigned &b) {
 	}
 	// If there is a carry left over, increase blocks until
 	// one does not roll over.
-	for (; i < a2->len && carryIn; i++) {
-		temp = a2->blk[i] + 1;
+	for (; i < aLen && carryIn; i++) {
+		temp = aBlk[i] + 1;
 		carryIn = (temp == 0);
 		blk[i] = temp;
 	}
 	// If the carry was resolved but the larger number
-	// still has blocks, copy them over.
-	for (; i < a2->len; i++)
-		blk[i] = a2->blk[i];
-	// Set the extra block if there's still a carry, decrease length otherwise
+	// still has blocks, copy them over (unless they are already ours).
+	if (blk != aBlk)
+		for (; i < aLen; i++)
+			blk[i] = aBlk[i];
+	// Set the extra block if there's still a carry
+	len = aLen;
 	if (carryIn)
-		blk[i] = 1;
-	else
-		len--;
+		blk[len++] = 1;
 }
 
 void BigUnsigned::subtract(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, subtract(a, b));
 	if (b.len == 0) {
 		// If b is zero, copy a.
 		operator =(a);
@@ -195,15 +195,20 @@ void BigUnsigned::subtract(const BigUnsigned &a, const BigUnsigned &b) {
 	bool borrowIn, borrowOut;
 	Blk temp;
 	Index i;
-	// Set preliminary length and make room
-	len = a.len;
-	allocate(len);
+	// Read the lengths before ours changes, in case we are an input.
+	Index aLen = a.len, bLen = b.len;
+	// Make room, keeping our blocks if they are b
+	if (this == &b)
+		allocateAndCopy(aLen);
+	else
+		allocate(aLen);
+	const Blk *aBlk = a.blk, *bBlk = b.blk;
 	// For each block index that is present in both inputs...
-	for (i = 0, borrowIn = false; i < b.len; i++) {
-		temp = a.blk[i] - b.blk[i];
+	for (i = 0, borrowIn = false; i < bLen; i++) {
+		temp = aBlk[i] - bBlk[i];
 		// If a reverse rollover occurred,
 		// the result is greater than the block from a.
-		borrowOut = (temp > a.blk[i]);
+		borrowOut = (temp > aBlk[i]);
 		// Handle an incoming borrow
 		if (borrowIn) {
 			borrowOut |= (temp == 0);
@@ -214,9 +219,9 @@ void BigUnsigned::subtract(const BigUnsigned &a, const BigUnsigned &b) {
 	}
 	// If there is a borrow left over, decrease blocks until
 	// one does not reverse rollover.
-	for (; i < a.len && borrowIn; i++) {
-		borrowIn = (a.blk[i] == 0);
-		blk[i] = a.blk[i] - 1;
+	for (; i < aLen && borrowIn; i++) {
+		borrowIn = (aBlk[i] == 0);
+		blk[i] = aBlk[i] - 1;
 	}
 	/* If there's still a borrow, the result is negative.
 	 * Throw an exception, but zero out this object so as to leave it in a
@@ -224,10 +229,11 @@ void BigUnsigned::subtract(const BigUnsigned &a, const BigUnsigned &b) {
 	if (borrowIn) {
 		len = 0;
 		throw "BigUnsigned::subtract: Negative result in unsigned calculation";
-	} else
-		// Copy over the rest of the blocks
-		for (; i < a.len; i++)
-			blk[i] = a.blk[i];
+	} else if (blk != aBlk)
+		// Copy over the rest of the blocks (unless they are already ours)
+		for (; i < aLen; i++)
+			blk[i] = aBlk[i];
+	len = aLen;
 	// Zap leading zeros
 	zapLeadingZeros();
 }
@@ -297,13 +303,152 @@ inline BigUnsigned::Blk getShiftedBlock(const BigUnsigned &num,
 	return part1 | part2;
 }
 
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+/* LIMB KERNELS
+ * With a double-width type, multiplication and division can work a whole
+ * block at a time instead of a bit at a time.  These operate on raw block
+ * arrays, least significant block first. */
+namespace {
+	typedef BigUnsigned::Blk Blk;
+	typedef BigUnsigned::Index Index;
+	const unsigned int N = BigUnsigned::N;
+
+	// Below this many blocks in the shorter operand, Karatsuba doesn't pay.
+	const Index karatsubaThreshold = 32;
+
+	// r[0 .. rn) += a[0 .. an) with an <= rn; returns the carry out.
+	Blk addInPlace(Blk *r, Index rn, const Blk *a, Index an) {
+		Blk carry = 0;
+		Index i;
+		for (i = 0; i < an; i++) {
+			DoubleBlk sum = DoubleBlk(r[i]) + a[i] + carry;
+			r[i] = Blk(sum);
+			carry = Blk(sum >> N);
+		}
+		for (; i < rn && carry != 0; i++) {
+			r[i]++;
+			carry = (r[i] == 0);
+		}
+		return carry;
+	}
+
+	// r[0 .. rn) -= a[0 .. an) with an <= rn; returns the borrow out.
+	Blk subtractInPlace(Blk *r, Index rn, const Blk *a, Index an) {
+		Blk borrow = 0;
+		Index i;
+		for (i = 0; i < an; i++) {
+			DoubleBlk diff = DoubleBlk(r[i]) - a[i] - borrow;
+			r[i] = Blk(diff);
+			borrow = (diff >> N) != 0;
+		}
+		for (; i < rn && borrow != 0; i++) {
+			borrow = (r[i] == 0);
+			r[i]--;
+		}
+		return borrow;
+	}
+
+	// r[0 .. an + bn) = a * b, schoolbook.  r must not overlap a or b.
+	void multiplyBasecase(Blk *r, const Blk *a, Index an, const Blk *b, Index bn) {
+		Index i, j;
+		for (i = 0; i < an + bn; i++)
+			r[i] = 0;
+		for (i = 0; i < an; i++) {
+			Blk ai = a[i], carry = 0;
+			// At most (2^N - 1)^2 + 2 * (2^N - 1), which fits.
+			for (j = 0; j < bn; j++) {
+				DoubleBlk cur = DoubleBlk(ai) * b[j] + r[i + j] + carry;
+				r[i + j] = Blk(cur);
+				carry = Blk(cur >> N);
+			}
+			r[i + bn] = carry;
+		}
+	}
+
+	/* r[0 .. an + bn) = a * b for an >= bn.  Splits a and b in halves at h
+	 * blocks and uses (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 for the middle
+	 * term, so three half-size products replace four. */
+	void multiplyBlocks(Blk *r, const Blk *a, Index an, const Blk *b, Index bn) {
+		if (bn < karatsubaThreshold) {
+			multiplyBasecase(r, a, an, b, bn);
+			return;
+		}
+		Index i;
+		if (an >= 2 * bn) {
+			// Very unbalanced: multiply b by bn-block pieces of a.
+			for (i = 0; i < an + bn; i++)
+				r[i] = 0;
+			BigScratchFrame scratch;
+			Blk *piece = scratch.take(2 * bn);
+			for (Index off = 0; off < an; off += bn) {
+				Index pn = (an - off < bn) ? an - off : bn;
+				if (pn >= bn)
+					multiplyBlocks(piece, a + off, pn, b, bn);
+				else
+					multiplyBlocks(piece, b, bn, a + off, pn);
+				addInPlace(r + off, an + bn - off, piece, pn + bn);
+			}
+			return;
+		}
+
+		Index h = an / 2;
+		Index a1n = an - h, b1n = bn - h;
+		// z0 = a0 b0 goes to the bottom of r, z2 = a1 b1 to the top.
+		multiplyBlocks(r, a, h, b, h);
+		if (a1n >= b1n)
+			multiplyBlocks(r + 2 * h, a + h, a1n, b + h, b1n);
+		else
+			multiplyBlocks(r + 2 * h, b + h, b1n, a + h, a1n);
+
+		// The sums a0 + a1 and b0 + b1, each with room for a carry
+		Index sn = a1n + 1, tn = (b1n > h ? b1n : h) + 1;
+		BigScratchFrame scratch;
+		Blk *sa = scratch.take(sn + tn + sn + tn);
+		Blk *sb = sa + sn;
+		Blk *z1 = sb + tn;
+		for (i = 0; i < sn; i++)
+			sa[i] = (i < a1n) ? a[h + i] : 0;
+		addInPlace(sa, sn, a, h);
+		for (i = 0; i < tn; i++)
+			sb[i] = (i < b1n) ? b[h + i] : 0;
+		addInPlace(sb, tn, b, h);
+
+		// z1 = (a0 + a1)(b0 + b1) - z0 - z2, added in at block h
+		multiplyBlocks(z1, sa, sn, sb, tn);
+		Index zn = sn + tn;
+		subtractInPlace(z1, zn, r, 2 * h);
+		subtractInPlace(z1, zn, r + 2 * h, a1n + b1n);
+		while (zn > 0 && z1[zn - 1] == 0)
+			zn--;
+		addInPlace(r + h, an + bn - h, z1, zn);
+	}
+}
+#endif
+
 void BigUnsigned::multiply(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, multiply(a, b));
+	// The product can't overwrite its inputs; build it aside and take its array.
+	if (this == &a || this == &b) {
+		BigUnsigned product;
+		product.multiply(a, b);
+		operator =(std::move(product));
+		return;
+	}
 	// If either a or b is zero, set to zero.
 	if (a.len == 0 || b.len == 0) {
 		len = 0;
 		return;
 	}
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	len = a.len + b.len;
+	allocate(len);
+	if (a.len >= b.len)
+		multiplyBlocks(blk, a.blk, a.len, b.blk, b.len);
+	else
+		multiplyBlocks(blk, b.blk, b.len, a.blk, a.len);
+	// Zap possible leading zero
+	if (blk[len - 1] == 0)
+		len--;
+#else
 	/*
 	 * Overall method:
 	 *
@@ -366,6 +511,7 @@ void BigUnsigned::multiply(const BigUnsigned &a, const BigUnsigned &b) {
 	// Zap possible leading zero
 	if (blk[len - 1] == 0)
 		len--;
+#endif
 }
 
 /*
@@ -420,6 +566,85 @@ void BigUnsigned::divideWithRemainder(const BigUnsigned &b, BigUnsigned &q) {
 
 	// At this point we know (*this).len >= b.len > 0.  (Whew!)
 
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	/*
+	 * With a double-width type, use Knuth's Algorithm D (TAOCP 4.3.1),
+	 * which finds a whole block of the quotient per step.  The divisor is
+	 * shifted so that its top bit is set; then the estimate from the top two
+	 * blocks of the remainder is at most two too large.
+	 */
+	Index n = b.len, m = len - b.len;
+	Index i, j;
+	q.len = m + 1;
+	q.allocate(q.len);
+	if (n == 1) {
+		// A single-block divisor needs no estimates.
+		DoubleBlk r = 0;
+		for (i = len; i > 0; i--) {
+			DoubleBlk cur = (r << N) | blk[i - 1];
+			q.blk[i - 1] = Blk(cur / b.blk[0]);
+			r = cur % b.blk[0];
+		}
+		len = 1;
+		blk[0] = Blk(r);
+	} else {
+		unsigned int shift = 0;
+		while ((b.blk[n - 1] << shift) >> (N - 1) == 0)
+			shift++;
+		// Normalized copies of the divisor and the dividend
+		BigScratchFrame scratch;
+		Blk *vn = scratch.take(n + len + 1);
+		Blk *un = vn + n;
+		for (i = n - 1; i > 0; i--)
+			vn[i] = (b.blk[i] << shift) | (shift == 0 ? 0 : b.blk[i - 1] >> (N - shift));
+		vn[0] = b.blk[0] << shift;
+		un[len] = (shift == 0) ? 0 : blk[len - 1] >> (N - shift);
+		for (i = len - 1; i > 0; i--)
+			un[i] = (blk[i] << shift) | (shift == 0 ? 0 : blk[i - 1] >> (N - shift));
+		un[0] = blk[0] << shift;
+
+		for (j = m + 1; j > 0; ) {
+			j--;
+			// Estimate the quotient block from the top blocks.
+			DoubleBlk num = (DoubleBlk(un[j + n]) << N) | un[j + n - 1];
+			DoubleBlk qhat = num / vn[n - 1];
+			DoubleBlk rhat = num % vn[n - 1];
+			while ((qhat >> N) != 0
+					|| qhat * vn[n - 2] > ((rhat << N) | un[j + n - 2])) {
+				qhat--;
+				rhat += vn[n - 1];
+				if ((rhat >> N) != 0)
+					break;
+			}
+			// Subtract qhat times the divisor.
+			Blk carry = 0, borrow = 0;
+			for (i = 0; i < n; i++) {
+				DoubleBlk product = qhat * vn[i] + carry;
+				carry = Blk(product >> N);
+				DoubleBlk diff = DoubleBlk(un[i + j]) - Blk(product) - borrow;
+				un[i + j] = Blk(diff);
+				borrow = (diff >> N) != 0;
+			}
+			DoubleBlk diff = DoubleBlk(un[j + n]) - carry - borrow;
+			un[j + n] = Blk(diff);
+			q.blk[j] = Blk(qhat);
+			// If that went negative, qhat was one too large: add back.
+			if ((diff >> N) != 0) {
+				q.blk[j]--;
+				un[j + n] += addInPlace(un + j, n, vn, n);
+			}
+		}
+		// The remainder is in the bottom n blocks, still shifted.
+		len = n;
+		for (i = 0; i < n; i++)
+			blk[i] = (un[i] >> shift) | (shift == 0 ? 0 : un[i + 1] << (N - shift));
+	}
+	// Zap leading zeros in quotient and remainder
+	while (q.len > 0 && q.blk[q.len - 1] == 0)
+		q.len--;
+	zapLeadingZeros();
+#else
+
 	/*
 	 * Overall method:
 	 *
@@ -464,7 +689,8 @@ void BigUnsigned::divideWithRemainder(const BigUnsigned &b, BigUnsigned &q) {
 	blk[origLen] = 0; // Zero the added block.
 
 	// subtractBuf holds part of the result of a subtraction; see above.
-	Blk *subtractBuf = new Blk[len];
+	BigScratchFrame scratch;
+	Blk *subtractBuf = scratch.take(len);
 
 	// Set preliminary length for quotient and make room
 	q.len = origLen - b.len + 1;
@@ -532,9 +758,57 @@ void BigUnsigned::divideWithRemainder(const BigUnsigned &b, BigUnsigned &q) {
 		q.len--;
 	// Zap any/all leading zeros in remainder
 	zapLeadingZeros();
-	// Deallocate subtractBuf.
-	// (Thanks to Brad Spencer for noticing my accidental omission of this!)
-	delete [] subtractBuf;
+	// subtractBuf goes back to the scratch arena with the frame.
+#endif
+}
+
+/* SINGLE-BLOCK OPERATIONS
+ * Radix conversion divides or multiplies by a power of the base that fits in a
+ * block, which takes one pass with a double-width type.  Without one, fall
+ * back to the general routines. */
+
+BigUnsigned::Blk BigUnsigned::divideBlock(Blk d) {
+	if (d == 0)
+		throw "BigUnsigned::divideBlock: Division by zero";
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	DoubleBlk r = 0;
+	for (Index i = len; i > 0; i--) {
+		DoubleBlk cur = (r << N) | blk[i - 1];
+		blk[i - 1] = Blk(cur / d);
+		r = cur % d;
+	}
+	zapLeadingZeros();
+	return Blk(r);
+#else
+	BigUnsigned q;
+	divideWithRemainder(BigUnsigned(d), q);
+	Blk r = getBlock(0);
+	operator =(q);
+	return r;
+#endif
+}
+
+void BigUnsigned::multiplyAddBlock(Blk m, Blk a) {
+#ifdef BIGUNSIGNED_DOUBLE_BLK
+	DoubleBlk carry = a;
+	for (Index i = 0; i < len; i++) {
+		// At most (2^N - 1)^2 + 2^N - 1, which fits.
+		DoubleBlk cur = DoubleBlk(blk[i]) * m + carry;
+		blk[i] = Blk(cur);
+		carry = cur >> N;
+	}
+	if (carry != 0) {
+		allocateAndCopy(len + 1);
+		blk[len] = Blk(carry);
+		len++;
+	}
+	// If m is zero, the blocks are now zero.
+	zapLeadingZeros();
+#else
+	BigUnsigned product;
+	product.multiply(*this, BigUnsigned(m));
+	add(product, BigUnsigned(a));
+#endif
 }
 
 /* BITWISE OPERATORS
@@ -542,18 +816,18 @@ void BigUnsigned::divideWithRemainder(const BigUnsigned &b, BigUnsigned &q) {
  * the output length and the necessity of zapLeadingZeros. */
 
 void BigUnsigned::bitAnd(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, bitAnd(a, b));
-	// The bitwise & can't be longer than either operand.
-	len = (a.len >= b.len) ? b.len : a.len;
-	allocate(len);
+	// The bitwise & can't be longer than either operand.  If we are an
+	// operand, no reallocation is needed.
+	Index newLen = (a.len >= b.len) ? b.len : a.len;
+	allocate(newLen);
 	Index i;
-	for (i = 0; i < len; i++)
+	for (i = 0; i < newLen; i++)
 		blk[i] = a.blk[i] & b.blk[i];
+	len = newLen;
 	zapLeadingZeros();
 }
 
 void BigUnsigned::bitOr(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, bitOr(a, b));
 	Index i;
 	const BigUnsigned *a2, *b2;
 	if (a.len >= b.len) {
@@ -563,17 +837,22 @@ void BigUnsigned::bitOr(const BigUnsigned &a, const BigUnsigned &b) {
 		a2 = &b;
 		b2 = &a;
 	}
-	allocate(a2->len);
-	for (i = 0; i < b2->len; i++)
-		blk[i] = a2->blk[i] | b2->blk[i];
-	for (; i < a2->len; i++)
-		blk[i] = a2->blk[i];
-	len = a2->len;
+	Index aLen = a2->len, bLen = b2->len;
+	if (this == &a || this == &b)
+		allocateAndCopy(aLen);
+	else
+		allocate(aLen);
+	const Blk *aBlk = a2->blk, *bBlk = b2->blk;
+	for (i = 0; i < bLen; i++)
+		blk[i] = aBlk[i] | bBlk[i];
+	if (blk != aBlk)
+		for (; i < aLen; i++)
+			blk[i] = aBlk[i];
+	len = aLen;
 	// Doesn't need zapLeadingZeros.
 }
 
 void BigUnsigned::bitXor(const BigUnsigned &a, const BigUnsigned &b) {
-	DTRT_ALIASED(this == &a || this == &b, bitXor(a, b));
 	Index i;
 	const BigUnsigned *a2, *b2;
 	if (a.len >= b.len) {
@@ -583,17 +862,32 @@ void BigUnsigned::bitXor(const BigUnsigned &a, const BigUnsigned &b) {
 		a2 = &b;
 		b2 = &a;
 	}
-	allocate(a2->len);
-	for (i = 0; i < b2->len; i++)
-		blk[i] = a2->blk[i] ^ b2->blk[i];
-	for (; i < a2->len; i++)
-		blk[i] = a2->blk[i];
-	len = a2->len;
+	Index aLen = a2->len, bLen = b2->len;
+	if (this == &a || this == &b)
+		allocateAndCopy(aLen);
+	else
+		allocate(aLen);
+	const Blk *aBlk = a2->blk, *bBlk = b2->blk;
+	for (i = 0; i < bLen; i++)
+		blk[i] = aBlk[i] ^ bBlk[i];
+	if (blk != aBlk)
+		for (; i < aLen; i++)
+			blk[i] = aBlk[i];
+	len = aLen;
 	zapLeadingZeros();
 }
 
+/* Returns block x of the aLen-block number aBlk shifted y bits left, for
+ * 0 <= x <= aLen and 0 <= y < N.  This is getShiftedBlock on a raw array,
+ * so the shifts can read blocks that they are overwriting. */
+inline BigUnsigned::Blk shiftedBlock(const BigUnsigned::Blk *aBlk,
+	BigUnsigned::Index aLen, BigUnsigned::Index x, unsigned int y) {
+	BigUnsigned::Blk part1 = (x == 0 || y == 0) ? 0 : (aBlk[x - 1] >> (BigUnsigned::N - y));
+	BigUnsigned::Blk part2 = (x == aLen) ? 0 : (aBlk[x] << y);
+	return part1 | part2;
+}
+
 void BigUnsigned::bitShiftLeft(const BigUnsigned &a, int b) {
-	DTRT_ALIASED(this == &a, bitShiftLeft(a, b));
 	if (b < 0) {
 		if (b << 1 == 0)
 			throw "BigUnsigned::bitShiftLeft: "
@@ -603,23 +897,34 @@ void BigUnsigned::bitShiftLeft(const BigUnsigned &a, int b) {
 			return;
 		}
 	}
+	// Zero stays zero, with no blocks.
+	if (a.len == 0) {
+		len = 0;
+		return;
+	}
 	Index shiftBlocks = b / N;
 	unsigned int shiftBits = b % N;
+	Index aLen = a.len;
 	// + 1: room for high bits nudged left into another block
-	len = a.len + shiftBlocks + 1;
-	allocate(len);
-	Index i, j;
-	for (i = 0; i < shiftBlocks; i++)
-		blk[i] = 0;
-	for (j = 0, i = shiftBlocks; j <= a.len; j++, i++)
-		blk[i] = getShiftedBlock(a, j, shiftBits);
+	Index newLen = aLen + shiftBlocks + 1;
+	if (this == &a)
+		allocateAndCopy(newLen);
+	else
+		allocate(newLen);
+	const Blk *aBlk = a.blk;
+	// From the top down, so block j of a is read before it is overwritten
+	Index j;
+	for (j = aLen + 1; j-- > 0; )
+		blk[j + shiftBlocks] = shiftedBlock(aBlk, aLen, j, shiftBits);
+	for (j = 0; j < shiftBlocks; j++)
+		blk[j] = 0;
+	len = newLen;
 	// Zap possible leading zero
 	if (blk[len - 1] == 0)
 		len--;
 }
 
 void BigUnsigned::bitShiftRight(const BigUnsigned &a, int b) {
-	DTRT_ALIASED(this == &a, bitShiftRight(a, b));
 	if (b < 0) {
 		if (b << 1 == 0)
 			throw "BigUnsigned::bitShiftRight: "
@@ -630,7 +935,7 @@ void BigUnsigned::bitShiftRight(const BigUnsigned &a, int b) {
 		}
 	}
 	// This calculation is wacky, but expressing the shift as a left bit shift
-	// within each block lets us use getShiftedBlock.
+	// within each block lets us use shiftedBlock.
 	Index rightShiftBlocks = (b + N - 1) / N;
 	unsigned int leftShiftBits = N * rightShiftBlocks - b;
 	// Now (N * rightShiftBlocks - leftShiftBits) == b
@@ -643,11 +948,18 @@ void BigUnsigned::bitShiftRight(const BigUnsigned &a, int b) {
 	}
 	// Now we're allocating a positive amount.
 	// + 1: room for high bits nudged left into another block
-	len = a.len + 1 - rightShiftBlocks;
-	allocate(len);
+	Index aLen = a.len;
+	Index newLen = aLen + 1 - rightShiftBlocks;
+	if (this == &a)
+		allocateAndCopy(newLen);
+	else
+		allocate(newLen);
+	const Blk *aBlk = a.blk;
+	// From the bottom up: block i is written after blocks i and up are read.
 	Index i, j;
-	for (j = rightShiftBlocks, i = 0; j <= a.len; j++, i++)
-		blk[i] = getShiftedBlock(a, j, leftShiftBits);
+	for (j = rightShiftBlocks, i = 0; j <= aLen; j++, i++)
+		blk[i] = shiftedBlock(aBlk, aLen, j, leftShiftBits);
+	len = newLen;
 	// Zap possible leading zero
 	if (blk[len - 1] == 0)
 		len--;
@@ -2,22 +2,52 @@
 #define BIGUNSIGNED_H
 
 #include "NumberlikeArray.hh"
+#include <utility>
+
+/* The width of a block in bits, 32 or 64.  The kernels in BigUnsigned.cc work
+ * a block at a time with a type twice as wide, so 64-bit blocks pay off only
+ * where the compiler has a 128-bit type; without one they fall back to the
+ * shift-and-add kernels.  Define BIGUNSIGNED_BLK_BITS to override this. */
+#ifndef BIGUNSIGNED_BLK_BITS
+	#ifdef __SIZEOF_INT128__
+		#define BIGUNSIGNED_BLK_BITS 64
+	#else
+		#define BIGUNSIGNED_BLK_BITS 32
+	#endif
+#endif
+
+#if BIGUNSIGNED_BLK_BITS == 64
+	typedef unsigned long long BigUnsignedBlk;
+#elif BIGUNSIGNED_BLK_BITS == 32
+	typedef unsigned int BigUnsignedBlk;
+#else
+	#error BIGUNSIGNED_BLK_BITS must be 32 or 64
+#endif
+
+// An unsigned type twice as wide as a block, if the compiler has one
+#if BIGUNSIGNED_BLK_BITS == 32
+	#define BIGUNSIGNED_DOUBLE_BLK
+	typedef unsigned long long BigUnsignedDoubleBlk;
+#elif defined(__SIZEOF_INT128__)
+	#define BIGUNSIGNED_DOUBLE_BLK
+	typedef unsigned __int128 BigUnsignedDoubleBlk;
+#endif
 
 /* A BigUnsigned object represents a nonnegative integer of size limited only by
  * available memory.  BigUnsigneds support most mathematical operators and can
  * be converted to and from most primitive integer types.
  *
- * The number is stored as a NumberlikeArray of unsigned longs as if it were
- * written in base 256^sizeof(unsigned long).  The least significant block is
- * first, and the length is such that the most significant block is nonzero. */
-class BigUnsigned : protected NumberlikeArray<unsigned long> {
+ * The number is stored as a NumberlikeArray of blocks as if it were written in
+ * base 2^BIGUNSIGNED_BLK_BITS.  The least significant block is first, and the
+ * length is such that the most significant block is nonzero. */
+class BigUnsigned : protected NumberlikeArray<BigUnsignedBlk> {
 
 public:
 	// Enumeration for the result of a comparison.
 	enum CmpRes { less = -1, equal = 0, greater = 1 };
 
-	// BigUnsigneds are built with a Blk type of unsigned long.
-	typedef unsigned long Blk;
+	// BigUnsigneds are built with the Blk type chosen above.
+	typedef BigUnsignedBlk Blk;
 
 	typedef NumberlikeArray<Blk>::Index Index;
 	using NumberlikeArray<Blk>::N;
@@ -39,11 +69,19 @@ public:
 	// Copy constructor
 	BigUnsigned(const BigUnsigned &x) : NumberlikeArray<Blk>(x) {}
 
+	// Move constructor; leaves x zero.
+	BigUnsigned(BigUnsigned &&x) : NumberlikeArray<Blk>(std::move(x)) {}
+
 	// Assignment operator
 	void operator=(const BigUnsigned &x) {
 		NumberlikeArray<Blk>::operator =(x);
 	}
 
+	// Move assignment operator; leaves x zero.
+	void operator=(BigUnsigned &&x) {
+		NumberlikeArray<Blk>::operator =(std::move(x));
+	}
+
 	// Constructor that copies from a given array of blocks.
 	BigUnsigned(const Blk *b, Index blen) : NumberlikeArray<Blk>(b, blen) {
 		// Eliminate any leading zeros we may have been passed.
@@ -54,12 +92,14 @@ public:
 	~BigUnsigned() {}
 	
 	// Constructors from primitive integer types
-	BigUnsigned(unsigned long  x);
-	BigUnsigned(         long  x);
-	BigUnsigned(unsigned int   x);
-	BigUnsigned(         int   x);
-	BigUnsigned(unsigned short x);
-	BigUnsigned(         short x);
+	BigUnsigned(unsigned long long x);
+	BigUnsigned(         long long x);
+	BigUnsigned(unsigned long      x);
+	BigUnsigned(         long      x);
+	BigUnsigned(unsigned int       x);
+	BigUnsigned(         int       x);
+	BigUnsigned(unsigned short     x);
+	BigUnsigned(         short     x);
 protected:
 	// Helpers
 	template <class X> void initFromPrimitive      (X x);
@@ -69,12 +109,14 @@ public:
 	/* Converters to primitive integer types
 	 * The implicit conversion operators caused trouble, so these are now
 	 * named. */
-	unsigned long  toUnsignedLong () const;
-	long           toLong         () const;
-	unsigned int   toUnsignedInt  () const;
-	int            toInt          () const;
-	unsigned short toUnsignedShort() const;
-	short          toShort        () const;
+	unsigned long long toUnsignedLongLong() const;
+	long long          toLongLong        () const;
+	unsigned long      toUnsignedLong    () const;
+	long               toLong            () const;
+	unsigned int       toUnsignedInt     () const;
+	int                toInt             () const;
+	unsigned short     toUnsignedShort   () const;
+	short              toShort           () const;
 protected:
 	// Helpers
 	template <class X> X convertToSignedPrimitive() const;
@@ -93,6 +135,13 @@ public:
 	/* Sets the requested block.  The number grows or shrinks as necessary. */
 	void setBlock(Index i, Blk newBlock);
 
+	/* Native access for the fast paths of BigInteger.  getSmall stores the
+	 * number in x and returns true if it takes at most 64 bits.  setSmall
+	 * sets the number to x; that fits in the inline blocks, so it never
+	 * allocates. */
+	bool getSmall(unsigned long long &x) const;
+	void setSmall(unsigned long long x);
+
 	// The number is zero if and only if the canonical length is zero.
 	bool isZero() const { return NumberlikeArray<Blk>::isEmpty(); }
 
@@ -167,8 +216,11 @@ public:
 	 *     c.divideWithRemainder(b, d);
 	 *     // 50 / 7; now d == 7 (quotient) and c == 1 (remainder).
 	 *
-	 *     // ``Aliased'' calls now do the right thing using a temporary
-	 *     // copy, but see note on `divideWithRemainder'.
+	 *     // ``Aliased'' calls do the right thing: add, subtract, the
+	 *     // bitwise operations and the shifts work in place, and
+	 *     // multiply builds the product in a temporary that is then
+	 *     // moved into the receiver.  But see note on
+	 *     // `divideWithRemainder'.
 	 *     a.add(a, b); 
 	 */
 
@@ -194,6 +246,13 @@ public:
 	 * sense to write quotient and remainder into the same variable. */
 	void divideWithRemainder(const BigUnsigned &b, BigUnsigned &q);
 
+	/* SINGLE-BLOCK OPERATIONS, done in place in one pass over the blocks.
+	 * `divideBlock(d)' is like `r = *this % d, *this /= d, return r' and
+	 * throws if d is zero.  `multiplyAddBlock(m, a)' is like
+	 * `*this = *this * m + a'. */
+	Blk divideBlock(Blk d);
+	void multiplyAddBlock(Blk m, Blk a);
+
 	/* `divide' and `modulo' are no longer offered.  Use
 	 * `divideWithRemainder' instead. */
 
@@ -339,6 +398,21 @@ inline void BigUnsigned::operator >>=(int b) {
 	bitShiftRight(*this, b);
 }
 
+// The 64 bits of a small value take sizeof(unsigned long long) / sizeof(Blk) blocks.
+inline bool BigUnsigned::getSmall(unsigned long long &x) const {
+	if (len > sizeof(unsigned long long) / sizeof(Blk))
+		return false;
+	x = 0;
+	for (Index i = 0; i < len; i++)
+		x |= (unsigned long long)(blk[i]) << (i * N);
+	return true;
+}
+inline void BigUnsigned::setSmall(unsigned long long x) {
+	// Two shifts, since shifting by N at once is undefined for 64-bit blocks
+	for (len = 0; x != 0; x = (x >> (N - 1)) >> 1)
+		blk[len++] = Blk(x);
+}
+
 /* Templates for conversions of BigUnsigned to and from primitive integers.
  * BigInteger.cc needs to instantiate convertToPrimitive, and the uses in
  * BigUnsigned.cc didn't do the trick; I think g++ inlined convertToPrimitive
@@ -356,13 +430,13 @@ template <class X>
 void BigUnsigned::initFromPrimitive(X x) {
 	if (x == 0)
 		; // NumberlikeArray already initialized us to zero.
-	else {
-		// Create a single block.  blk is NULL; no need to delete it.
-		cap = 1;
-		blk = new Blk[1];
+	else if (sizeof(X) <= sizeof(Blk)) {
+		// Use a single block, which the inline storage always has room for.
 		len = 1;
 		blk[0] = Blk(x);
-	}
+	} else
+		// Spread it over as many blocks as it takes.
+		setSmall((unsigned long long)(x));
 }
 
 /* Ditto, but first check that x is nonnegative.  I could have put the check in
@@ -385,14 +459,15 @@ void BigUnsigned::initFromSignedPrimitive(X x) {
  * clearer, which is the library's stated goal. */
 template <class X>
 X BigUnsigned::convertToPrimitive() const {
+	unsigned long long value;
 	if (len == 0)
 		// The number is zero; return zero.
 		return 0;
-	else if (len == 1) {
-		// The single block might fit in an X.  Try the conversion.
-		X x = X(blk[0]);
-		// Make sure the result accurately represents the block.
-		if (Blk(x) == blk[0])
+	else if (getSmall(value)) {
+		// The value might fit in an X.  Try the conversion.
+		X x = X(value);
+		// Make sure the result accurately represents the value.
+		if ((unsigned long long)(x) == value)
 			// Successful conversion.
 			return x;
 		// Otherwise fall through.
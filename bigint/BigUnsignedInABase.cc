@@ -1,4 +1,6 @@
 #include "BigUnsignedInABase.hh"
+#include "BigRadix.hh"
+#include "BigScratch.hh"
 
 BigUnsignedInABase::BigUnsignedInABase(const Digit *d, Index l, Base base)
 	: NumberlikeArray<Digit>(d, l), base(base) {
@@ -27,6 +29,11 @@ namespace {
 	unsigned int ceilingDiv(unsigned int a, unsigned int b) {
 		return (a + b - 1) / b;
 	}
+	/* Returns the number of bits per digit if base is a power of two, so
+	 * that digits are just bit fields of the blocks, or 0 otherwise. */
+	unsigned int bitsPerDigit(unsigned int base) {
+		return (base >= 2 && (base & (base - 1)) == 0) ? bitLen(base) - 1 : 0;
+	}
 }
 
 BigUnsignedInABase::BigUnsignedInABase(const BigUnsigned &x, Base base) {
@@ -35,6 +42,26 @@ BigUnsignedInABase::BigUnsignedInABase(const BigUnsigned &x, Base base) {
 		throw "BigUnsignedInABase(BigUnsigned, Base): The base must be at least 2";
 	this->base = base;
 
+	unsigned int digitBits = bitsPerDigit(base);
+	if (digitBits != 0) {
+		// Cut the digits straight out of the blocks.
+		BigUnsigned::Index bits = x.bitLength();
+		len = ceilingDiv(bits, digitBits);
+		allocate(len);
+		Digit mask = Digit(base - 1);
+		for (Index digitNum = 0; digitNum < len; digitNum++) {
+			BigUnsigned::Index bitNum = digitNum * digitBits;
+			BigUnsigned::Index blockNum = bitNum / BigUnsigned::N;
+			unsigned int offset = bitNum % BigUnsigned::N;
+			BigUnsigned::Blk field = x.getBlock(blockNum) >> offset;
+			// A digit may straddle two blocks.
+			if (offset + digitBits > BigUnsigned::N)
+				field |= x.getBlock(blockNum + 1) << (BigUnsigned::N - offset);
+			blk[digitNum] = Digit(field & mask);
+		}
+		return;
+	}
+
 	// Get an upper bound on how much space we need
 	int maxBitLenOfX = x.getLength() * BigUnsigned::N;
 	int minBitsPerDigit = bitLen(base) - 1;
@@ -42,32 +69,72 @@ BigUnsignedInABase::BigUnsignedInABase(const BigUnsigned &x, Base base) {
 	len = maxDigitLenOfX; // Another change to comply with `staying in bounds'.
 	allocate(len); // Get the space
 
-	BigUnsigned x2(x), buBase(base);
+	BigUnsigned::Blk power;
+	unsigned int chunkDigits;
+	radixChunk(base, power, chunkDigits);
+	BigUnsigned::Index chunkCount;
+	BigUnsigned::Blk *chunks = bigUnsignedToChunks(x, base, chunkCount);
 	Index digitNum = 0;
 
-	while (!x2.isZero()) {
-		// Get last digit.  This is like `lastDigit = x2 % buBase, x2 /= buBase'.
-		BigUnsigned lastDigit(x2);
-		lastDigit.divideWithRemainder(buBase, x2);
-		// Save the digit.
-		blk[digitNum] = lastDigit.toUnsignedShort();
-		// Move on.  We can't run out of room: we figured it out above.
-		digitNum++;
+	for (BigUnsigned::Index chunkNum = 0; chunkNum < chunkCount; chunkNum++) {
+		// Take each chunk apart with ordinary arithmetic.
+		BigUnsigned::Blk chunk = chunks[chunkNum];
+		// Every chunk but the most significant one has exactly chunkDigits digits.
+		bool last = (chunkNum == chunkCount - 1);
+		for (unsigned int i = 0; i < chunkDigits && !(last && chunk == 0); i++) {
+			blk[digitNum] = Digit(chunk % base);
+			chunk /= base;
+			// Move on.  We can't run out of room: we figured it out above.
+			digitNum++;
+		}
 	}
+	delete [] chunks;
 
 	// Save the actual length.
 	len = digitNum;
 }
 
 BigUnsignedInABase::operator BigUnsigned() const {
-	BigUnsigned ans(0), buBase(base), temp;
-	Index digitNum = len;
-	while (digitNum > 0) {
-		digitNum--;
-		temp.multiply(ans, buBase);
-		ans.add(temp, BigUnsigned(blk[digitNum]));
+	unsigned int digitBits = bitsPerDigit(base);
+	if (digitBits != 0) {
+		// Pack the digits straight into blocks.
+		BigUnsigned::Index blockLen = ceilingDiv(len * digitBits, BigUnsigned::N);
+		BigScratchFrame scratch;
+		BigUnsigned::Blk *blocks = scratch.take(blockLen);
+		for (BigUnsigned::Index i = 0; i < blockLen; i++)
+			blocks[i] = 0;
+		for (Index digitNum = 0; digitNum < len; digitNum++) {
+			BigUnsigned::Index bitNum = digitNum * digitBits;
+			BigUnsigned::Index blockNum = bitNum / BigUnsigned::N;
+			unsigned int offset = bitNum % BigUnsigned::N;
+			BigUnsigned::Blk digit = blk[digitNum];
+			blocks[blockNum] |= digit << offset;
+			if (offset + digitBits > BigUnsigned::N)
+				blocks[blockNum + 1] |= digit >> (BigUnsigned::N - offset);
+		}
+		return BigUnsigned(blocks, blockLen);
+	}
+
+	// Group the digits into chunks and assemble those.
+	if (len == 0)
+		return BigUnsigned();
+	BigUnsigned::Blk power;
+	unsigned int chunkDigits;
+	radixChunk(base, power, chunkDigits);
+	BigUnsigned::Index chunkCount = ceilingDiv(len, chunkDigits);
+	BigScratchFrame scratch;
+	BigUnsigned::Blk *chunks = scratch.take(chunkCount);
+	for (BigUnsigned::Index chunkNum = 0; chunkNum < chunkCount; chunkNum++) {
+		Index first = chunkNum * chunkDigits;
+		Index digitNum = (first + chunkDigits < len) ? first + chunkDigits : len;
+		BigUnsigned::Blk chunk = 0;
+		while (digitNum > first) {
+			digitNum--;
+			chunk = chunk * base + blk[digitNum];
+		}
+		chunks[chunkNum] = chunk;
 	}
-	return ans;
+	return chunksToBigUnsigned(chunks, chunkCount, base);
 }
 
 BigUnsignedInABase::BigUnsignedInABase(const std::string &s, Base base) {
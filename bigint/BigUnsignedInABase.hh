@@ -14,6 +14,8 @@
  * functionality of its own.  BigUnsignedInABase objects can be constructed
  * from, and converted to, BigUnsigneds (requiring multiplication, mods, etc.)
  * and `std::string's (by switching digit values for appropriate characters).
+ * In power-of-two bases the digits are just bit fields of the blocks, so
+ * those conversions copy bits directly and take linear time.
  *
  * BigUnsignedInABase is similar to BigUnsigned.  Note the following:
  *
@@ -57,12 +59,21 @@ public:
 	// Copy constructor
 	BigUnsignedInABase(const BigUnsignedInABase &x) : NumberlikeArray<Digit>(x), base(x.base) {}
 
+	// Move constructor; leaves x zero.
+	BigUnsignedInABase(BigUnsignedInABase &&x) : NumberlikeArray<Digit>(std::move(x)), base(x.base) {}
+
 	// Assignment operator
 	void operator =(const BigUnsignedInABase &x) {
 		NumberlikeArray<Digit>::operator =(x);
 		base = x.base;
 	}
 
+	// Move assignment operator; leaves x zero.
+	void operator =(BigUnsignedInABase &&x) {
+		NumberlikeArray<Digit>::operator =(std::move(x));
+		base = x.base;
+	}
+
 	// Constructor that copies from a given array of digits.
 	BigUnsignedInABase(const Digit *d, Index l, Base base);
 
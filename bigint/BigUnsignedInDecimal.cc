@@ -0,0 +1,147 @@
+#include "BigUnsignedInDecimal.hh"
+#include "BigRadix.hh"
+
+namespace {
+	typedef BigUnsignedInDecimal::Limb Limb;
+	typedef BigUnsignedInDecimal::Index Index;
+
+	/* The chunk of this base in BigRadix is 10^9 with 32-bit blocks and 10^18
+	 * with 64-bit ones, which is exactly a limb. */
+	const unsigned int radixBase = 1000000000;
+}
+
+const BigUnsignedInDecimal::Limb BigUnsignedInDecimal::limbBase =
+	Limb(sizeof(Limb) >= 8 ? 1000000000000000000ULL : 1000000000ULL);
+const unsigned int BigUnsignedInDecimal::limbDigits = sizeof(Limb) >= 8 ? 18 : 9;
+
+BigUnsignedInDecimal::BigUnsignedInDecimal(const BigUnsigned &x) : NumberlikeArray<Limb>() {
+	Index count;
+	Limb *chunks = bigUnsignedToChunks(x, radixBase, count);
+	allocate(count);
+	len = count;
+	for (Index i = 0; i < len; i++)
+		blk[i] = chunks[i];
+	delete [] chunks;
+}
+
+BigUnsignedInDecimal::operator BigUnsigned() const {
+	return chunksToBigUnsigned(blk, len, radixBase);
+}
+
+BigUnsignedInDecimal::BigUnsignedInDecimal(const char *s, size_t length) : NumberlikeArray<Limb>() {
+	allocate(Index((length + limbDigits - 1) / limbDigits));
+	len = 0;
+	// Fill the limbs from the least significant end of the string.
+	size_t end = length;
+	while (end > 0) {
+		size_t start = end > limbDigits ? end - limbDigits : 0;
+		Limb limb = 0;
+		for (size_t i = start; i < end; i++) {
+			unsigned char digit = (unsigned char)(s[i] - '0');
+			if (digit > 9)
+				throw "BigUnsignedInDecimal(const char *, size_t): Bad symbol in input.  Only 0-9 are accepted.";
+			limb = limb * 10 + digit;
+		}
+		blk[len++] = limb;
+		end = start;
+	}
+	zapLeadingZeros();
+}
+
+size_t BigUnsignedInDecimal::digitCount() const {
+	if (len == 0)
+		return 1;
+	size_t count = size_t(len - 1) * limbDigits;
+	for (Limb top = blk[len - 1]; top != 0; top /= 10)
+		count++;
+	return count;
+}
+
+size_t BigUnsignedInDecimal::toChars(char *buf, size_t size) const {
+	size_t length = digitCount();
+	if (size == 0)
+		return length;
+	size_t written = length < size ? length : size - 1;
+	if (len == 0) {
+		if (written > 0)
+			buf[0] = '0';
+		buf[written] = '\0';
+		return length;
+	}
+	/* Produce the digits from the least significant end, dropping the ones
+	 * that do not fit: digit i from the left lands at buf[i]. */
+	size_t pos = length;
+	for (Index i = 0; i < len; i++) {
+		Limb limb = blk[i];
+		unsigned int digits = (i == len - 1) ? (unsigned int)(pos) : limbDigits;
+		for (unsigned int j = 0; j < digits; j++) {
+			pos--;
+			if (pos < written)
+				buf[pos] = char('0' + limb % 10);
+			limb /= 10;
+		}
+	}
+	buf[written] = '\0';
+	return length;
+}
+
+BigUnsignedInDecimal::CmpRes BigUnsignedInDecimal::compareTo(const BigUnsignedInDecimal &x) const {
+	if (len != x.len)
+		return len < x.len ? BigUnsigned::less : BigUnsigned::greater;
+	for (Index i = len; i > 0; i--) {
+		if (blk[i - 1] != x.blk[i - 1])
+			return blk[i - 1] < x.blk[i - 1] ? BigUnsigned::less : BigUnsigned::greater;
+	}
+	return BigUnsigned::equal;
+}
+
+void BigUnsignedInDecimal::add(const BigUnsignedInDecimal &a, const BigUnsignedInDecimal &b) {
+	// Growing the array would lose an aliased operand, so work on a copy.
+	if (this == &a || this == &b) {
+		BigUnsignedInDecimal tmpThis;
+		tmpThis.add(a, b);
+		*this = tmpThis;
+		return;
+	}
+	const BigUnsignedInDecimal &longer = a.len >= b.len ? a : b;
+	const BigUnsignedInDecimal &shorter = a.len >= b.len ? b : a;
+	allocate(longer.len + 1);
+	Limb carry = 0;
+	Index i;
+	// Both limbs are below limbBase, so the sum plus a carry cannot overflow.
+	for (i = 0; i < longer.len; i++) {
+		Limb sum = longer.blk[i] + (i < shorter.len ? shorter.blk[i] : 0) + carry;
+		carry = sum >= limbBase ? 1 : 0;
+		blk[i] = carry ? sum - limbBase : sum;
+	}
+	if (carry)
+		blk[i++] = 1;
+	len = i;
+}
+
+void BigUnsignedInDecimal::subtract(const BigUnsignedInDecimal &a, const BigUnsignedInDecimal &b) {
+	if (a.compareTo(b) == BigUnsigned::less)
+		throw "BigUnsignedInDecimal::subtract: Negative result in unsigned calculation";
+	if (this == &b && this != &a) {
+		BigUnsignedInDecimal tmpThis;
+		tmpThis.subtract(a, b);
+		*this = tmpThis;
+		return;
+	}
+	// The result is never longer than a, so working in place on a is safe.
+	allocate(a.len);
+	Limb borrow = 0;
+	Index i;
+	for (i = 0; i < a.len; i++) {
+		Limb sub = (i < b.len ? b.blk[i] : 0) + borrow;
+		if (a.blk[i] >= sub) {
+			blk[i] = a.blk[i] - sub;
+			borrow = 0;
+		} else {
+			blk[i] = a.blk[i] + (limbBase - sub);
+			borrow = 1;
+		}
+	}
+	len = a.len;
+	zapLeadingZeros();
+}
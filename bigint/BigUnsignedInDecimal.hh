@@ -0,0 +1,119 @@
+#ifndef BIGUNSIGNEDINDECIMAL_H
+#define BIGUNSIGNEDINDECIMAL_H
+
+#include <cstddef>
+#include "NumberlikeArray.hh"
+#include "BigUnsigned.hh"
+
+/*
+ * A BigUnsignedInDecimal object represents a nonnegative integer as limbs of
+ * base 10^9 (with 32-bit blocks) or 10^18 (with 64-bit blocks), least
+ * significant first.  Each limb holds a fixed number of decimal digits, so
+ * reading and writing decimal strings takes linear time and no division.
+ *
+ * Addition, subtraction and comparison work on the limbs directly, with a
+ * carry that is a plain comparison against the limb base.  Anything else
+ * goes through a BigUnsigned; that conversion is done with the chunked radix
+ * code in BigRadix, since a limb is exactly a chunk of base 10^9.
+ *
+ * Like BigUnsigned, zero has no limbs and the top limb of any other value is
+ * nonzero.
+ */
+
+class BigUnsignedInDecimal : protected NumberlikeArray<BigUnsigned::Blk> {
+
+public:
+	// Limbs are blocks holding a value below limbBase.
+	typedef BigUnsigned::Blk Limb;
+	typedef NumberlikeArray<Limb>::Index Index;
+	typedef BigUnsigned::CmpRes CmpRes;
+
+	// The limb base, 10^limbDigits
+	static const Limb limbBase;
+	static const unsigned int limbDigits;
+
+	// Constructs zero.
+	BigUnsignedInDecimal() : NumberlikeArray<Limb>() {}
+
+	// Copy constructor
+	BigUnsignedInDecimal(const BigUnsignedInDecimal &x) : NumberlikeArray<Limb>(x) {}
+
+	// Move constructor; leaves x zero.
+	BigUnsignedInDecimal(BigUnsignedInDecimal &&x) : NumberlikeArray<Limb>(std::move(x)) {}
+
+	// Assignment operator
+	void operator =(const BigUnsignedInDecimal &x) {
+		NumberlikeArray<Limb>::operator =(x);
+	}
+
+	// Move assignment operator; leaves x zero.
+	void operator =(BigUnsignedInDecimal &&x) {
+		NumberlikeArray<Limb>::operator =(std::move(x));
+	}
+
+	// Destructor.  NumberlikeArray does the delete for us.
+	~BigUnsignedInDecimal() {}
+
+	// LINKS TO BIGUNSIGNED
+	BigUnsignedInDecimal(const BigUnsigned &x);
+	operator BigUnsigned() const;
+
+	/* LINKS TO STRINGS.  The constructor reads length decimal digits, with
+	 * no sign, and throws on any other character.  toChars follows the
+	 * semantics of snprintf: it writes at most size - 1 digits and a
+	 * terminator and returns the full length of the number. */
+	BigUnsignedInDecimal(const char *s, size_t length);
+	size_t toChars(char *buf, size_t size) const;
+
+	// Returns the number of decimal digits, which is 1 for zero.
+	size_t digitCount() const;
+
+	// ACCESSORS
+	Index getLength() const { return len; }
+	Limb getLimb(Index i) const { return i >= len ? 0 : blk[i]; }
+	bool isZero() const { return NumberlikeArray<Limb>::isEmpty(); }
+
+	// COMPARISONS
+	CmpRes compareTo(const BigUnsignedInDecimal &x) const;
+	bool operator ==(const BigUnsignedInDecimal &x) const {
+		return NumberlikeArray<Limb>::operator ==(x);
+	}
+	bool operator !=(const BigUnsignedInDecimal &x) const { return !operator ==(x); }
+	bool operator < (const BigUnsignedInDecimal &x) const { return compareTo(x) == BigUnsigned::less   ; }
+	bool operator <=(const BigUnsignedInDecimal &x) const { return compareTo(x) != BigUnsigned::greater; }
+	bool operator >=(const BigUnsignedInDecimal &x) const { return compareTo(x) != BigUnsigned::less   ; }
+	bool operator > (const BigUnsignedInDecimal &x) const { return compareTo(x) == BigUnsigned::greater; }
+
+	/* COPY-LESS OPERATIONS.  The result may alias either operand.  Like
+	 * BigUnsigned, subtract throws if the result would be negative. */
+	void add(const BigUnsignedInDecimal &a, const BigUnsignedInDecimal &b);
+	void subtract(const BigUnsignedInDecimal &a, const BigUnsignedInDecimal &b);
+
+	// OVERLOADED RETURN-BY-VALUE OPERATORS
+	BigUnsignedInDecimal operator +(const BigUnsignedInDecimal &x) const;
+	BigUnsignedInDecimal operator -(const BigUnsignedInDecimal &x) const;
+
+	// OVERLOADED ASSIGNMENT OPERATORS
+	void operator +=(const BigUnsignedInDecimal &x) { add(*this, x); }
+	void operator -=(const BigUnsignedInDecimal &x) { subtract(*this, x); }
+
+private:
+	// Removes leading zero limbs.
+	void zapLeadingZeros() {
+		while (len > 0 && blk[len - 1] == 0)
+			len--;
+	}
+};
+
+inline BigUnsignedInDecimal BigUnsignedInDecimal::operator +(const BigUnsignedInDecimal &x) const {
+	BigUnsignedInDecimal ans;
+	ans.add(*this, x);
+	return ans;
+}
+inline BigUnsignedInDecimal BigUnsignedInDecimal::operator -(const BigUnsignedInDecimal &x) const {
+	BigUnsignedInDecimal ans;
+	ans.subtract(*this, x);
+	return ans;
+}
+
+#endif
@@ -0,0 +1,230 @@
+#include "BigUnsignedInRNS.hh"
+
+namespace {
+	typedef BigUnsignedInRNS::Residue Residue;
+	typedef BigUnsignedInRNS::Index Index;
+
+	const Index maxResidues = 1024;
+
+	Residue mulmod(Residue a, Residue b, Residue m) {
+		return Residue((unsigned long long)a * b % m);
+	}
+
+	Residue powmod(Residue a, Residue e, Residue m) {
+		Residue ans = 1;
+		while (e != 0) {
+			if (e & 1)
+				ans = mulmod(ans, a, m);
+			a = mulmod(a, a, m);
+			e >>= 1;
+		}
+		return ans;
+	}
+
+	// Miller-Rabin with the bases 2, 7 and 61, which is exact below 2^32.
+	bool isPrime(Residue n) {
+		static const Residue bases[] = { 2, 7, 61 };
+		Residue d = n - 1;
+		unsigned int s = 0;
+		while ((d & 1) == 0) {
+			d >>= 1;
+			s++;
+		}
+		for (unsigned int i = 0; i < 3; i++) {
+			Residue x = powmod(bases[i], d, n);
+			if (x == 1 || x == n - 1)
+				continue;
+			unsigned int j;
+			for (j = 1; j < s; j++) {
+				x = mulmod(x, x, n);
+				if (x == n - 1)
+					break;
+			}
+			if (j == s)
+				return false;
+		}
+		return true;
+	}
+
+	/* The moduli: the largest primes below 2^31, in decreasing order.  A
+	 * residue fits in 31 bits, so a residue times 2^32 plus a 32-bit chunk
+	 * still fits in an unsigned long long. */
+	const Residue *moduli() {
+		static Residue list[maxResidues];
+		static bool initialized = false;
+		if (!initialized) {
+			Index count = 0;
+			for (Residue c = 0x7FFFFFFF; count < maxResidues; c -= 2)
+				if (isPrime(c))
+					list[count++] = c;
+			initialized = true;
+		}
+		return list;
+	}
+
+	/* The constants for converting back from a given size: a product tree
+	 * over the moduli, stored heap-style (node 1 covers all of them and the
+	 * children of node n are 2n and 2n + 1), and for each modulus m_i the
+	 * inverse of M / m_i modulo m_i. */
+	class RNSBasis {
+		Index size;
+		BigUnsigned *products;
+		Residue *inverses;
+
+		void build(Index node, Index lo, Index hi) {
+			if (hi - lo == 1) {
+				products[node] = BigUnsigned(moduli()[lo]);
+				return;
+			}
+			Index mid = lo + (hi - lo) / 2;
+			build(2 * node, lo, mid);
+			build(2 * node + 1, mid, hi);
+			products[node].multiply(products[2 * node], products[2 * node + 1]);
+		}
+
+		/* Returns the sum of c_i * P / m_i over the moduli of the node, where
+		 * P is the product of the node. */
+		BigUnsigned combine(const Residue *c, Index node, Index lo, Index hi) const {
+			if (hi - lo == 1)
+				return BigUnsigned(c[lo]);
+			Index mid = lo + (hi - lo) / 2;
+			return combine(c, 2 * node, lo, mid) * products[2 * node + 1]
+				+ combine(c, 2 * node + 1, mid, hi) * products[2 * node];
+		}
+
+	public:
+		RNSBasis(Index size) : size(size) {
+			products = new BigUnsigned[4 * size];
+			build(1, 0, size);
+			inverses = new Residue[size];
+			const Residue *m = moduli();
+			for (Index i = 0; i < size; i++) {
+				Residue others = 1;
+				for (Index j = 0; j < size; j++)
+					if (j != i)
+						others = mulmod(others, m[j] % m[i], m[i]);
+				inverses[i] = powmod(others, m[i] - 2, m[i]);
+			}
+		}
+
+		~RNSBasis() {
+			delete [] products;
+			delete [] inverses;
+		}
+
+		// Chinese remaindering: x = (sum of r_i * inverse_i * M / m_i) % M
+		BigUnsigned reconstruct(const Residue *r) const {
+			const Residue *m = moduli();
+			Residue *c = new Residue[size];
+			for (Index i = 0; i < size; i++)
+				c[i] = mulmod(r[i], inverses[i], m[i]);
+			BigUnsigned x(combine(c, 1, 0, size));
+			delete [] c;
+			// The sum is less than size * M, so the quotient is small.
+			BigUnsigned q;
+			x.divideWithRemainder(products[1], q);
+			return x;
+		}
+	};
+
+	// Bases are built on first use and kept until the library is unloaded.
+	class RNSBasisCache {
+		RNSBasis *bases[maxResidues + 1];
+
+	public:
+		RNSBasisCache() {
+			for (Index i = 0; i <= maxResidues; i++)
+				bases[i] = NULL;
+		}
+
+		~RNSBasisCache() {
+			for (Index i = 0; i <= maxResidues; i++)
+				delete bases[i];
+		}
+
+		const RNSBasis &get(Index size) {
+			if (bases[size] == NULL)
+				bases[size] = new RNSBasis(size);
+			return *bases[size];
+		}
+	};
+
+	RNSBasisCache basisCache;
+}
+
+const BigUnsignedInRNS::Index BigUnsignedInRNS::maxSize = maxResidues;
+
+BigUnsignedInRNS::Index BigUnsignedInRNS::sizeForBits(Index bits) {
+	/* All moduli exceed 2^31 * (1 - 2^-14), so the product of size of them
+	 * is larger than 2^(31 * size - 1). */
+	Index size = bits / 31 + 1;
+	if (size > maxResidues)
+		throw "BigUnsignedInRNS::sizeForBits: Too many bits for a residue number system";
+	return size;
+}
+
+BigUnsignedInRNS::Residue BigUnsignedInRNS::getModulus(Index i) {
+	if (i >= maxResidues)
+		throw "BigUnsignedInRNS::getModulus: Index out of range";
+	return moduli()[i];
+}
+
+BigUnsignedInRNS::BigUnsignedInRNS(const BigUnsigned &x, Index size) : NumberlikeArray<Residue>(size) {
+	if (size == 0 || size > maxResidues)
+		throw "BigUnsignedInRNS(const BigUnsigned &, Index): Invalid size";
+	len = size;
+	const Residue *m = moduli();
+	Index i;
+	for (i = 0; i < len; i++)
+		blk[i] = 0;
+	/* Reduce x modulo every prime at once, feeding in 32-bit chunks from the
+	 * most significant end. */
+	for (Index b = x.getLength(); b-- > 0; ) {
+		BigUnsigned::Blk block = x.getBlock(b);
+		for (unsigned int shift = BigUnsigned::N; shift > 0; ) {
+			shift -= 32;
+			unsigned long long chunk = (block >> shift) & 0xFFFFFFFFUL;
+			for (i = 0; i < len; i++)
+				blk[i] = Residue((((unsigned long long)blk[i] << 32) | chunk) % m[i]);
+		}
+	}
+}
+
+BigUnsignedInRNS::operator BigUnsigned() const {
+	if (len == 0)
+		return BigUnsigned();
+	return basisCache.get(len).reconstruct(blk);
+}
+
+void BigUnsignedInRNS::add(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b) {
+	if (a.len != b.len)
+		throw "BigUnsignedInRNS::add: The operands have different sizes";
+	allocate(a.len);
+	len = a.len;
+	const Residue *m = moduli();
+	for (Index i = 0; i < len; i++) {
+		// Both residues are below 2^31, so the sum cannot overflow.
+		Residue sum = a.blk[i] + b.blk[i];
+		blk[i] = sum >= m[i] ? sum - m[i] : sum;
+	}
+}
+
+void BigUnsignedInRNS::subtract(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b) {
+	if (a.len != b.len)
+		throw "BigUnsignedInRNS::subtract: The operands have different sizes";
+	allocate(a.len);
+	len = a.len;
+	const Residue *m = moduli();
+	for (Index i = 0; i < len; i++)
+		blk[i] = a.blk[i] >= b.blk[i] ? a.blk[i] - b.blk[i] : a.blk[i] + (m[i] - b.blk[i]);
+}
+
+void BigUnsignedInRNS::multiply(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b) {
+	if (a.len != b.len)
+		throw "BigUnsignedInRNS::multiply: The operands have different sizes";
+	allocate(a.len);
+	len = a.len;
+	const Residue *m = moduli();
+	for (Index i = 0; i < len; i++)
+		blk[i] = mulmod(a.blk[i], b.blk[i], m[i]);
+}
@@ -0,0 +1,113 @@
+#ifndef BIGUNSIGNEDINRNS_H
+#define BIGUNSIGNEDINRNS_H
+
+#include "NumberlikeArray.hh"
+#include "BigUnsigned.hh"
+
+/*
+ * A BigUnsignedInRNS object represents a nonnegative integer in a residue
+ * number system: as its residues modulo the first `size' primes of a fixed
+ * list of primes just below 2^31.  It can represent values below the product
+ * M of those primes; arithmetic wraps around modulo M.
+ *
+ * Addition, subtraction and multiplication work on each residue on its own
+ * with single-word arithmetic and no carries, so long chains of them are
+ * cheap.  The price is paid when converting: a BigUnsigned is reduced modulo
+ * each prime, and the way back is a Chinese remaindering whose sum is
+ * combined up a product tree of the primes.  The product tree and the CRT
+ * constants are computed once per size and shared.
+ *
+ * Operands must have the same size.  Pick the size with sizeForBits so that
+ * every intermediate result fits; subtraction results are only meaningful if
+ * the true difference is nonnegative.  The primes and the shared tables are
+ * built on first use without locking.
+ */
+
+class BigUnsignedInRNS : protected NumberlikeArray<unsigned int> {
+
+public:
+	// The residues and moduli of a BigUnsignedInRNS are unsigned ints.
+	typedef unsigned int Residue;
+	typedef NumberlikeArray<Residue>::Index Index;
+
+	// The largest supported number of residues (about 31700 bits)
+	static const Index maxSize;
+
+	// Constructs zero with no residues.
+	BigUnsignedInRNS() : NumberlikeArray<Residue>() {}
+
+	// Copy constructor
+	BigUnsignedInRNS(const BigUnsignedInRNS &x) : NumberlikeArray<Residue>(x) {}
+
+	// Move constructor; leaves x without residues.
+	BigUnsignedInRNS(BigUnsignedInRNS &&x) : NumberlikeArray<Residue>(std::move(x)) {}
+
+	// Assignment operator
+	void operator =(const BigUnsignedInRNS &x) {
+		NumberlikeArray<Residue>::operator =(x);
+	}
+
+	// Move assignment operator; leaves x without residues.
+	void operator =(BigUnsignedInRNS &&x) {
+		NumberlikeArray<Residue>::operator =(std::move(x));
+	}
+
+	// Destructor.  NumberlikeArray does the delete for us.
+	~BigUnsignedInRNS() {}
+
+	/* Returns the smallest size whose range exceeds 2^bits.  Throws if that
+	 * is more than maxSize. */
+	static Index sizeForBits(Index bits);
+
+	// Returns the i-th prime modulus, for i < maxSize.
+	static Residue getModulus(Index i);
+
+	/* LINKS TO BIGUNSIGNED.  Converting a value of M or more stores it
+	 * modulo M. */
+	BigUnsignedInRNS(const BigUnsigned &x, Index size);
+	operator BigUnsigned() const;
+
+	// ACCESSORS
+	Index getSize() const { return len; }
+	Residue getResidue(Index i) const { return blk[i]; }
+
+	// Two values are equal if they have the same size and residues.
+	bool operator ==(const BigUnsignedInRNS &x) const {
+		return NumberlikeArray<Residue>::operator ==(x);
+	}
+	bool operator !=(const BigUnsignedInRNS &x) const { return !operator ==(x); }
+
+	/* COPY-LESS OPERATIONS, modulo M.  These throw if a and b differ in
+	 * size; the result may alias either operand. */
+	void add(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b);
+	void subtract(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b);
+	void multiply(const BigUnsignedInRNS &a, const BigUnsignedInRNS &b);
+
+	// OVERLOADED RETURN-BY-VALUE OPERATORS
+	BigUnsignedInRNS operator +(const BigUnsignedInRNS &x) const;
+	BigUnsignedInRNS operator -(const BigUnsignedInRNS &x) const;
+	BigUnsignedInRNS operator *(const BigUnsignedInRNS &x) const;
+
+	// OVERLOADED ASSIGNMENT OPERATORS
+	void operator +=(const BigUnsignedInRNS &x) { add(*this, x); }
+	void operator -=(const BigUnsignedInRNS &x) { subtract(*this, x); }
+	void operator *=(const BigUnsignedInRNS &x) { multiply(*this, x); }
+};
+
+inline BigUnsignedInRNS BigUnsignedInRNS::operator +(const BigUnsignedInRNS &x) const {
+	BigUnsignedInRNS ans;
+	ans.add(*this, x);
+	return ans;
+}
+inline BigUnsignedInRNS BigUnsignedInRNS::operator -(const BigUnsignedInRNS &x) const {
+	BigUnsignedInRNS ans;
+	ans.subtract(*this, x);
+	return ans;
+}
+inline BigUnsignedInRNS BigUnsignedInRNS::operator *(const BigUnsignedInRNS &x) const {
+	BigUnsignedInRNS ans;
+	ans.multiply(*this, x);
+	return ans;
+}
+
+#endif
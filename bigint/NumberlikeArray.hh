@@ -6,9 +6,16 @@
 #define NULL 0
 #endif
 
-/* A NumberlikeArray<Blk> object holds a heap-allocated array of Blk with a
- * length and a capacity and provides basic memory management features.
- * BigUnsigned and BigUnsignedInABase both subclass it.
+#include "BigPool.hh"
+
+/* A NumberlikeArray<Blk> object holds an array of Blk with a length and a
+ * capacity and provides basic memory management features.  BigUnsigned and
+ * BigUnsignedInABase both subclass it.
+ *
+ * Arrays of up to inlineCapacity blocks (256 bits) live inside the object,
+ * so small values such as SteamIDs and 64- to 128-bit counters, and the
+ * products of two of them, never touch the heap.  Larger arrays come from
+ * the pool in BigPool, rounded up to its size classes.
  *
  * NumberlikeArray provides no information hiding.  Subclasses should use
  * nonpublic inheritance and manually expose members as desired using
@@ -25,30 +32,52 @@ public:
 	typedef unsigned int Index;
 	// The number of bits in a block, defined below.
 	static const unsigned int N;
+	// The number of blocks stored inside the object
+	static const Index inlineCapacity = 32 / sizeof(Blk);
 
 	// The current allocated capacity of this NumberlikeArray (in blocks)
 	Index cap;
 	// The actual length of the value stored in this NumberlikeArray (in blocks)
 	Index len;
-	// Heap-allocated array of the blocks (can be NULL if len == 0)
+	// The array of the blocks: inlineBlk or a heap-allocated one
 	Blk *blk;
+	// Storage for arrays of up to inlineCapacity blocks
+	Blk inlineBlk[inlineCapacity];
+
+	/* Points blk at a pooled array of at least c blocks and sets cap to the
+	 * number of blocks it holds.  Doesn't free the old array. */
+	void newHeapArray(Index c) {
+		size_t count = c;
+		blk = poolNewArray<Blk>(count);
+		cap = Index(count);
+	}
+
+	// Returns the array to the pool unless it is the inline one.
+	void freeArray() {
+		if (blk != inlineBlk)
+			poolDeleteArray(blk, cap);
+	}
 
 	// Constructs a ``zero'' NumberlikeArray with the given capacity.
-	NumberlikeArray(Index c) : cap(c), len(0) { 
-		blk = (cap > 0) ? (new Blk[cap]) : NULL;
+	NumberlikeArray(Index c) : len(0) {
+		if (c > inlineCapacity) {
+			newHeapArray(c);
+		} else {
+			cap = inlineCapacity;
+			blk = inlineBlk;
+		}
 	}
 
-	/* Constructs a zero NumberlikeArray without allocating a backing array.
-	 * A subclass that doesn't know the needed capacity at initialization
-	 * time can use this constructor and then overwrite blk without first
-	 * deleting it. */
-	NumberlikeArray() : cap(0), len(0) {
-		blk = NULL;
+	/* Constructs a zero NumberlikeArray using the inline storage, so that
+	 * a subclass that doesn't know the needed capacity at initialization
+	 * time pays nothing until it calls allocate. */
+	NumberlikeArray() : cap(inlineCapacity), len(0) {
+		blk = inlineBlk;
 	}
 
-	// Destructor.  Note that `delete NULL' is a no-op.
+	// Destructor.  The inline storage is not freed.
 	~NumberlikeArray() {
-		delete [] blk;
+		freeArray();
 	}
 
 	/* Ensures that the array has at least the requested capacity; may
@@ -62,9 +91,16 @@ public:
 	// Copy constructor
 	NumberlikeArray(const NumberlikeArray<Blk> &x);
 
+	/* Move constructor.  Takes over a heap-allocated array and leaves x
+	 * empty. */
+	NumberlikeArray(NumberlikeArray<Blk> &&x);
+
 	// Assignment operator
 	void operator=(const NumberlikeArray<Blk> &x);
 
+	// Move assignment operator; leaves x empty.
+	void operator=(NumberlikeArray<Blk> &&x);
+
 	// Constructor that copies from a given array of blocks
 	NumberlikeArray(const Blk *b, Index blen);
 
@@ -90,15 +126,17 @@ public:
 template <class Blk>
 const unsigned int NumberlikeArray<Blk>::N = 8 * sizeof(Blk);
 
+template <class Blk>
+const typename NumberlikeArray<Blk>::Index NumberlikeArray<Blk>::inlineCapacity;
+
 template <class Blk>
 void NumberlikeArray<Blk>::allocate(Index c) {
 	// If the requested capacity is more than the current capacity...
 	if (c > cap) {
-		// Delete the old number array
-		delete [] blk;
+		// Free the old number array, unless it is the inline one
+		freeArray();
 		// Allocate the new array
-		cap = c;
-		blk = new Blk[cap];
+		newHeapArray(c);
 	}
 }
 
@@ -107,15 +145,16 @@ void NumberlikeArray<Blk>::allocateAndCopy(Index c) {
 	// If the requested capacity is more than the current capacity...
 	if (c > cap) {
 		Blk *oldBlk = blk;
+		Index oldCap = cap;
 		// Allocate the new number array
-		cap = c;
-		blk = new Blk[cap];
+		newHeapArray(c);
 		// Copy number blocks
 		Index i;
 		for (i = 0; i < len; i++)
 			blk[i] = oldBlk[i];
-		// Delete the old array
-		delete [] oldBlk;
+		// Free the old array, unless it is the inline one
+		if (oldBlk != inlineBlk)
+			poolDeleteArray(oldBlk, oldCap);
 	}
 }
 
@@ -123,8 +162,12 @@ template <class Blk>
 NumberlikeArray<Blk>::NumberlikeArray(const NumberlikeArray<Blk> &x)
 		: len(x.len) {
 	// Create array
-	cap = len;
-	blk = new Blk[cap];
+	if (len > inlineCapacity) {
+		newHeapArray(len);
+	} else {
+		cap = inlineCapacity;
+		blk = inlineBlk;
+	}
 	// Copy blocks
 	Index i;
 	for (i = 0; i < len; i++)
@@ -147,11 +190,57 @@ void NumberlikeArray<Blk>::operator=(const NumberlikeArray<Blk> &x) {
 		blk[i] = x.blk[i];
 }
 
+template <class Blk>
+NumberlikeArray<Blk>::NumberlikeArray(NumberlikeArray<Blk> &&x)
+		: len(x.len) {
+	if (x.blk != x.inlineBlk) {
+		// Take over the heap array
+		cap = x.cap;
+		blk = x.blk;
+		x.cap = inlineCapacity;
+		x.blk = x.inlineBlk;
+	} else {
+		// An inline array is short; copy it
+		cap = inlineCapacity;
+		blk = inlineBlk;
+		Index i;
+		for (i = 0; i < len; i++)
+			blk[i] = x.blk[i];
+	}
+	x.len = 0;
+}
+
+template <class Blk>
+void NumberlikeArray<Blk>::operator=(NumberlikeArray<Blk> &&x) {
+	if (this == &x)
+		return;
+	if (x.blk != x.inlineBlk) {
+		// Drop our own array and take over the heap array
+		freeArray();
+		cap = x.cap;
+		blk = x.blk;
+		x.cap = inlineCapacity;
+		x.blk = x.inlineBlk;
+	} else {
+		// An inline array always fits into our capacity
+		Index i;
+		for (i = 0; i < x.len; i++)
+			blk[i] = x.blk[i];
+	}
+	len = x.len;
+	x.len = 0;
+}
+
 template <class Blk>
 NumberlikeArray<Blk>::NumberlikeArray(const Blk *b, Index blen)
-		: cap(blen), len(blen) {
+		: len(blen) {
 	// Create array
-	blk = new Blk[cap];
+	if (len > inlineCapacity) {
+		newHeapArray(len);
+	} else {
+		cap = inlineCapacity;
+		blk = inlineBlk;
+	}
 	// Copy blocks
 	Index i;
 	for (i = 0; i < len; i++)
@@ -34,7 +34,17 @@ enum BigInt_Method
 	SET_DIRECT = 1
 };
 
+enum BigInt_ByteOrder
+{
+	BYTE_ORDER_BIG_ENDIAN = 0,
+	BYTE_ORDER_LITTLE_ENDIAN = 1
+};
+
 HandleType_t g_BigIntType = 0;
+HandleType_t g_BigIntCurveType = 0;
+HandleType_t g_BigIntPointType = 0;
+HandleType_t g_BigIntRNSType = 0;
+HandleType_t g_BigIntStreamType = 0;
 
 
 
@@ -43,8 +53,20 @@ sp_nativeinfo_t bigint_natives[] =
 {
 	{"BigInt_Create",               BigInt_Create},
 	{"BigInt_CreateFromString",     BigInt_CreateFromString},
+	{"BigInt_CreateLazy",           BigInt_CreateLazy},
+	{"BigInt_CreateDecimal",        BigInt_CreateDecimal},
 	{"BigInt_ToInt",                BigInt_ToInt},
 	{"BigInt_ToString",             BigInt_ToString},
+	{"BigInt_GetStringLength",      BigInt_GetStringLength},
+	{"BigInt_ToStringBegin",        BigInt_ToStringBegin},
+	{"BigInt_ToStringChunk",        BigInt_ToStringChunk},
+	{"BigInt_ToStringEnd",          BigInt_ToStringEnd},
+	{"BigInt_FromBytes",            BigInt_FromBytes},
+	{"BigInt_ToBytes",              BigInt_ToBytes},
+	{"BigInt_FromCells",            BigInt_FromCells},
+	{"BigInt_ToCells",              BigInt_ToCells},
+	{"BigInt_ToAlphabet",           BigInt_ToAlphabet},
+	{"BigInt_FromAlphabet",         BigInt_FromAlphabet},
 	{"BigInt_GetSign",              BigInt_GetSign},
 	{"BigInt_CompareTo",            BigInt_CompareTo},
 	{"BigInt_Negate",               BigInt_Negate},
@@ -62,6 +84,20 @@ sp_nativeinfo_t bigint_natives[] =
 	{"BigInt_Euclidean",            BigInt_Euclidean},
 	{"BigInt_ModInv",               BigInt_ModInv},
 	{"BigInt_ModExp",               BigInt_ModExp},
+	{"BigInt_ModMul",               BigInt_ModMul},
+	{"BigInt_ECCreateCurve",        BigInt_ECCreateCurve},
+	{"BigInt_ECCreatePoint",        BigInt_ECCreatePoint},
+	{"BigInt_ECGetPoint",           BigInt_ECGetPoint},
+	{"BigInt_ECAdd",                BigInt_ECAdd},
+	{"BigInt_ECMul",                BigInt_ECMul},
+	{"BigInt_ECVerify",             BigInt_ECVerify},
+	{"BigInt_RSAVerify",            BigInt_RSAVerify},
+	{"BigInt_RSAGenerate",          BigInt_RSAGenerate},
+	{"BigInt_RNSCreate",            BigInt_RNSCreate},
+	{"BigInt_RNSAdd",               BigInt_RNSAdd},
+	{"BigInt_RNSSubtract",          BigInt_RNSSubtract},
+	{"BigInt_RNSMultiply",          BigInt_RNSMultiply},
+	{"BigInt_RNSToBigInt",          BigInt_RNSToBigInt},
 	{NULL, NULL}
 };
 
@@ -92,6 +128,45 @@ bool BigIntExtension::SDK_OnLoad(char *error, size_t err_max, bool late)
 		return false;
 	}
 
+	// Create Handle Types for elliptic curves and their points
+	g_BigIntCurveType = g_pHandleSys->CreateType("BigIntCurve", this, 0, NULL, NULL, myself->GetIdentity(), &err);
+
+	if (g_BigIntCurveType == 0)
+	{
+		snprintf(error, err_max, "Could not create BigIntCurve handle type (err: %d)", err);
+
+		return false;
+	}
+
+	g_BigIntPointType = g_pHandleSys->CreateType("BigIntPoint", this, 0, NULL, NULL, myself->GetIdentity(), &err);
+
+	if (g_BigIntPointType == 0)
+	{
+		snprintf(error, err_max, "Could not create BigIntPoint handle type (err: %d)", err);
+
+		return false;
+	}
+
+	// Create a Handle Type for values in residue number system
+	g_BigIntRNSType = g_pHandleSys->CreateType("BigIntRNS", this, 0, NULL, NULL, myself->GetIdentity(), &err);
+
+	if (g_BigIntRNSType == 0)
+	{
+		snprintf(error, err_max, "Could not create BigIntRNS handle type (err: %d)", err);
+
+		return false;
+	}
+
+	// Create a Handle Type for streamed strings of BigInts
+	g_BigIntStreamType = g_pHandleSys->CreateType("BigIntStringStream", this, 0, NULL, NULL, myself->GetIdentity(), &err);
+
+	if (g_BigIntStreamType == 0)
+	{
+		snprintf(error, err_max, "Could not create BigIntStringStream handle type (err: %d)", err);
+
+		return false;
+	}
+
 
 	// Add the natives
 	sharesys->AddNatives(myself, bigint_natives);
@@ -106,6 +181,17 @@ bool BigIntExtension::SDK_OnLoad(char *error, size_t err_max, bool late)
 
 
 
+/**
+ * This is called right before the extension is unloaded.
+ */
+void BigIntExtension::SDK_OnUnload()
+{
+	// Give back the scratch memory of the main thread
+	scratchRelease();
+}
+
+
+
 /**
 * Called when destroying a handle. Must be implemented.
 *
@@ -117,364 +203,1925 @@ void BigIntExtension::OnHandleDestroy(HandleType_t type, void *object)
 	// Destroy our object here
 	if (type == g_BigIntType)
 	{
-		delete reinterpret_cast<BigInteger *>(object);
+		delete reinterpret_cast<BigIntObject *>(object);
+	}
+	else if (type == g_BigIntCurveType)
+	{
+		delete reinterpret_cast<BigEllipticCurve *>(object);
+	}
+	else if (type == g_BigIntPointType)
+	{
+		delete reinterpret_cast<BigCurvePoint *>(object);
+	}
+	else if (type == g_BigIntRNSType)
+	{
+		delete reinterpret_cast<BigUnsignedInRNS *>(object);
+	}
+	else if (type == g_BigIntStreamType)
+	{
+		delete reinterpret_cast<BigDigitStream *>(object);
 	}
 }
 
 
 
-// Creates a BigInt from a Int
-cell_t BigInt_Create(IPluginContext *pContext, const cell_t *params)
+// Keeps the string in the form BigInt_ToString writes it
+BigIntObject::BigIntObject(const char *str, size_t length, int base) : parsed(false), decimal(false), decimalValid(false), stringBase(base), missedBase(0)
 {
-	BigInteger* bigint = new BigInteger(params[1]);
+	size_t i = 0;
+	bool negative = false;
 
-	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-	if (!hndl)
+	// Only base 10 is signed
+	if (base == 10 && length > 0 && (str[0] == '-' || str[0] == '+'))
 	{
-		delete bigint;
+		negative = (str[0] == '-');
+		i++;
 	}
 
-	return hndl;
-}
-
-
+	while (i < length && str[i] == '0')
+	{
+		i++;
+	}
 
-// Creates a BigInt from a String
-cell_t BigInt_CreateFromString(IPluginContext *pContext, const cell_t *params)
-{
-	char *str;
-	int base = params[2];
-	pContext->LocalToString(params[1], &str);
+	cachedString.reserve(length - i + 2);
 
-	BigInteger* bigint;
+	if (negative && i < length)
+	{
+		cachedString += '-';
+	}
 
-	try
+	for (; i < length; i++)
 	{
-		if (base != 10)
-		{
-			bigint = new BigInteger(BigUnsignedInABase(str, base));
-		}
-		else
+		char c = str[i];
+		int digit = (c >= '0' && c <= '9') ? c - '0'
+			: (c >= 'A' && c <= 'Z') ? c - 'A' + 10
+			: (c >= 'a' && c <= 'z') ? c - 'a' + 10
+			: 36;
+
+		if (digit >= base)
 		{
-			bigint = new BigInteger(stringToBigInteger(str));
+			throw "BigIntObject: Bad symbol in input.  Only 0-9, A-Z, a-z below the base are accepted.";
 		}
+
+		cachedString += (c >= 'a') ? static_cast<char>(c - 'a' + 'A') : c;
 	}
-	catch (char *error)
+
+	if (cachedString.empty())
 	{
-		return pContext->ThrowNativeError("Couldn't create BigInt (error %s)", error);
+		cachedString = "0";
 	}
+}
 
 
-	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-	if (!hndl)
+// Parses the string of a lazy BigInt, or converts the decimal limbs
+void BigIntObject::parseString()
+{
+	if (decimalValid)
 	{
-		delete bigint;
+		BigInteger::operator =(BigInteger(BigUnsigned(decimalMagnitude), decimalSign));
+	}
+	else
+	{
+		BigInteger::operator =(charsToBigInteger(cachedString.data(), cachedString.size(), stringBase));
 	}
 
-	return hndl;
+	parsed = true;
 }
 
 
 
-// Int from BigInt
-cell_t BigInt_ToInt(IPluginContext *pContext, const cell_t *params)
+// Converts a base 10 string or the binary value to decimal limbs
+void BigIntObject::toDecimal()
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-
-	if (hndl == BAD_HANDLE)
+	if (decimalValid)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		return;
 	}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
-	BigInteger *bigint;
+	if (!parsed && stringBase == 10)
+	{
+		bool negative = (cachedString[0] == '-');
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+		decimalMagnitude = BigUnsignedInDecimal(cachedString.data() + negative, cachedString.size() - negative);
+		decimalSign = negative ? BigInteger::negative : decimalMagnitude.isZero() ? BigInteger::zero : BigInteger::positive;
+	}
+	else
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		parse();
+
+		decimalMagnitude = BigUnsignedInDecimal(getMagnitude());
+		decimalSign = getSign();
 	}
 
-	return bigint->toInt();
+	decimalValid = true;
 }
 
 
 
-
-// String from BigInt
-cell_t BigInt_ToString(IPluginContext *pContext, const cell_t *params)
+// Signed addition on the magnitudes, like BigInteger::add
+void BigIntObject::addDecimal(const BigIntObject &a, const BigIntObject &b, bool subtract)
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-	int base = params[4];
+	BigInteger::Sign signA = a.decimalSign;
+	BigInteger::Sign signB = subtract ? BigInteger::Sign(-b.decimalSign) : b.decimalSign;
 
-	if (hndl == BAD_HANDLE)
+	if (signB == BigInteger::zero)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		decimalMagnitude = a.decimalMagnitude;
+		decimalSign = signA;
 	}
-
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
-	BigInteger *bigint;
-
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	else if (signA == BigInteger::zero)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		decimalMagnitude = b.decimalMagnitude;
+		decimalSign = signB;
 	}
-
-	if (base != 10)
+	else if (signA == signB)
 	{
-		pContext->StringToLocal(params[2], params[3], std::string(BigUnsignedInABase(bigint->getMagnitude(), base)).c_str());
-
-		return 1;
+		decimalMagnitude.add(a.decimalMagnitude, b.decimalMagnitude);
+		decimalSign = signA;
+	}
+	else
+	{
+		switch (a.decimalMagnitude.compareTo(b.decimalMagnitude))
+		{
+			case BigUnsigned::equal:
+				decimalMagnitude = BigUnsignedInDecimal();
+				decimalSign = BigInteger::zero;
+				break;
+			case BigUnsigned::greater:
+				decimalMagnitude.subtract(a.decimalMagnitude, b.decimalMagnitude);
+				decimalSign = signA;
+				break;
+			case BigUnsigned::less:
+				decimalMagnitude.subtract(b.decimalMagnitude, a.decimalMagnitude);
+				decimalSign = signB;
+				break;
+		}
 	}
 
-	pContext->StringToLocal(params[2], params[3], bigIntegerToString(*bigint).c_str());
-
-	return 1;
+	// The binary value and the string are stale now
+	decimal = true;
+	decimalValid = true;
+	parsed = false;
+	stringBase = 0;
+	missedBase = 0;
+	std::string().swap(cachedString);
 }
 
 
 
-// Get Sign of BigInt
-cell_t BigInt_GetSign(IPluginContext *pContext, const cell_t *params)
+// Sign first, then the magnitudes
+BigInteger::CmpRes BigIntObject::compareDecimal(const BigIntObject &x) const
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-
-	if (hndl == BAD_HANDLE)
+	if (decimalSign != x.decimalSign)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		return (decimalSign < x.decimalSign) ? BigInteger::less : BigInteger::greater;
 	}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
-	BigInteger *bigint;
+	BigUnsigned::CmpRes cmp = decimalMagnitude.compareTo(x.decimalMagnitude);
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if (decimalSign == BigInteger::negative)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		return BigInteger::CmpRes(-cmp);
 	}
 
-	return (int)bigint->getSign();
+	return BigInteger::CmpRes(cmp);
 }
 
 
 
-// Compare two BigInts
-cell_t BigInt_CompareTo(IPluginContext *pContext, const cell_t *params)
+// Flips the sign of the decimal limbs
+void BigIntObject::negateDecimal()
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	decimalSign = BigInteger::Sign(-decimalSign);
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	parsed = false;
+	stringBase = 0;
+	missedBase = 0;
+	std::string().swap(cachedString);
+}
+
+
+
+// Compares canonical strings: sign, then length, then digits
+bool BigIntObject::compareStrings(const BigIntObject &x, BigInteger::CmpRes &result) const
+{
+	// Other bases drop the sign, unless the string is what the BigInt was created from
+	bool lazy = !parsed && !decimalValid;
+	bool lazyX = !x.parsed && !x.decimalValid;
+
+	if (stringBase == 0 || stringBase != x.stringBase || (stringBase != 10 && (!lazy || !lazyX)))
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		return false;
 	}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
+	bool negative = (cachedString[0] == '-');
+
+	if (negative != (x.cachedString[0] == '-'))
+	{
+		result = negative ? BigInteger::less : BigInteger::greater;
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+		return true;
+	}
 
+	int cmp;
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if (cachedString.size() != x.cachedString.size())
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		cmp = (cachedString.size() < x.cachedString.size()) ? -1 : 1;
+	}
+	else
+	{
+		cmp = cachedString.compare(x.cachedString);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if (negative)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+		cmp = -cmp;
 	}
 
+	result = (cmp < 0) ? BigInteger::less : (cmp > 0) ? BigInteger::greater : BigInteger::equal;
 
-	return (int)bigint->compareTo(*bigint2);
+	return true;
 }
 
 
 
-// Negates a BigInt
-cell_t BigInt_Negate(IPluginContext *pContext, const cell_t *params)
+// Converts the value or takes the cached string
+const std::string &BigIntObject::toString(int base)
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-
-	if (hndl == BAD_HANDLE)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
-	}
-
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
-	BigInteger *bigint;
-
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if (stringBase == base)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		return cachedString;
 	}
 
-	if (params[2] == RETURN_NEW)
+	// Decimal limbs are written out digit by digit
+	if (base == 10 && decimalValid)
 	{
-		BigInteger *newInt = new BigInteger(-(*bigint));
+		bool negative = (decimalSign == BigInteger::negative);
+		size_t length = decimalMagnitude.digitCount();
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+		cachedString.resize(negative + length + 1);
 
-		if (!hndlnew)
+		if (negative)
 		{
-			delete newInt;
+			cachedString[0] = '-';
 		}
 
-		return hndlnew;
+		decimalMagnitude.toChars(&cachedString[negative], length + 1);
+		cachedString.resize(negative + length);
+
+		stringBase = base;
 	}
 	else
 	{
-		bigint->negate(*bigint);
+		parse();
+
+		// The digits are written straight into the cache
+		if (base != 10)
+		{
+			BigDigitStream stream(getMagnitude(), base);
+			cacheStream(stream, base);
+		}
+		else
+		{
+			BigDigitStream stream(*this, base);
+			cacheStream(stream, base);
+		}
 	}
 
-	return hndl;
+	return cachedString;
 }
 
 
 
-// Adds to BigInts
-cell_t BigInt_Add(IPluginContext *pContext, const cell_t *params)
+// Reads all digits of a stream into the cache
+void BigIntObject::cacheStream(BigDigitStream &stream, int base)
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	cachedString.resize(stream.getLength() + 1);
+	stream.read(&cachedString[0], cachedString.size());
+	cachedString.resize(stream.getLength());
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
-	}
+	stringBase = base;
+}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
 
+// Converts the value into the buffer or copies the cached string
+size_t BigIntObject::writeString(int base, char *buf, size_t size)
+{
+	size_t length;
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if (stringBase == base)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
-	}
+		length = cachedString.size();
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
-	}
+		size_t written = (length < size) ? length : size - 1;
 
+		memcpy(buf, cachedString.data(), written);
+		buf[written] = '\0';
 
-	if (params[3] == RETURN_NEW)
+		return length;
+	}
+
+	// Decimal limbs are written out digit by digit
+	if (base == 10 && decimalValid)
 	{
-		BigInteger *newInt;
+		bool negative = (decimalSign == BigInteger::negative);
+		size_t offset = 0;
 
-		try
-		{
-			newInt = new BigInteger((*bigint) + (*bigint2));
-		}
-		catch (char *error)
+		if (negative && size > 1)
 		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+			buf[0] = '-';
+			offset = 1;
 		}
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+		length = negative + decimalMagnitude.toChars(buf + offset, size - offset);
+	}
+	else
+	{
+		parse();
 
-		if (!hndlnew)
+		// Only base 10 is signed
+		if (base != 10)
 		{
-			delete newInt;
+			length = bigUnsignedToChars(getMagnitude(), base, buf, size);
+		}
+		else
+		{
+			length = bigIntegerToChars(*this, base, buf, size);
 		}
-
-		return hndlnew;
 	}
-	else
+
+	// A string that fit is cached once it is asked for again
+	if (length < size)
 	{
-		try
+		if (missedBase == base)
 		{
-			(*bigint) += (*bigint2);
+			cachedString.assign(buf, length);
+			stringBase = base;
 		}
-		catch (char *error)
+		else
 		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+			missedBase = base;
 		}
 	}
 
-	return hndl;
+	return length;
 }
 
 
 
-// Subtracts two BigInts
-cell_t BigInt_Subtract(IPluginContext *pContext, const cell_t *params)
+// Reads a BigInt Handle
+HandleError ReadBigIntHandle(Handle_t hndl, const HandleSecurity *sec, BigIntObject **bigint, bool parse)
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
-	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	HandleError err = handlesys->ReadHandle(hndl, g_BigIntType, sec, (void **)bigint);
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	if (err == HandleError_None && parse)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		(*bigint)->parse();
 	}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
+	return err;
+}
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
-	}
+// Creates a BigInt from a Int
+cell_t BigInt_Create(IPluginContext *pContext, const cell_t *params)
+{
+	BigIntObject* bigint = new BigIntObject(params[1]);
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+		delete bigint;
 	}
 
+	return hndl;
+}
 
-	if (params[3] == RETURN_NEW)
-	{
-		BigInteger *newInt;
 
-		try
-		{
-			newInt = new BigInteger((*bigint) - (*bigint2));
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
-		}
+
+// Creates a BigInt from a String
+cell_t BigInt_CreateFromString(IPluginContext *pContext, const cell_t *params)
+{
+	char *str;
+	int base = params[2];
+	pContext->LocalToString(params[1], &str);
+
+	if (base < 2 || base > 36)
+	{
+		return pContext->ThrowNativeError("Invalid base %d", base);
+	}
+
+	BigIntObject* bigint;
+	size_t length = strlen(str);
+
+	// Parsed in place from the plugin's memory; only base 10 is signed
+	try
+	{
+		if (base != 10)
+		{
+			bigint = new BigIntObject(charsToBigUnsigned(str, length, base));
+		}
+		else
+		{
+			bigint = new BigIntObject(charsToBigInteger(str, length, base));
+		}
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("Couldn't create BigInt (error %s)", error);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Creates a BigInt from a String, parsing it only when needed
+cell_t BigInt_CreateLazy(IPluginContext *pContext, const cell_t *params)
+{
+	char *str;
+	int base = params[2];
+	pContext->LocalToString(params[1], &str);
+
+	if (base < 2 || base > 36)
+	{
+		return pContext->ThrowNativeError("Invalid base %d", base);
+	}
+
+	BigIntObject* bigint;
+
+	try
+	{
+		bigint = new BigIntObject(str, strlen(str), base);
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("Couldn't create BigInt (error %s)", error);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Creates a BigInt in decimal limbs from a base 10 String
+cell_t BigInt_CreateDecimal(IPluginContext *pContext, const cell_t *params)
+{
+	char *str;
+	pContext->LocalToString(params[1], &str);
+
+	BigIntObject* bigint;
+	size_t length = strlen(str);
+	size_t i = 0;
+	bool negative = false;
+
+	if (length > 0 && (str[0] == '-' || str[0] == '+'))
+	{
+		negative = (str[0] == '-');
+		i++;
+	}
+
+	try
+	{
+		BigUnsignedInDecimal magnitude(str + i, length - i);
+
+		bigint = new BigIntObject(magnitude, magnitude.isZero() ? BigInteger::zero : negative ? BigInteger::negative : BigInteger::positive);
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("Couldn't create BigInt (error %s)", error);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Int from BigInt
+cell_t BigInt_ToInt(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	return bigint->toInt();
+}
+
+
+
+
+// String from BigInt
+cell_t BigInt_ToString(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int base = params[4];
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (base < 2 || base > 36)
+	{
+		return pContext->ThrowNativeError("Invalid base %d", base);
+	}
+
+	if (params[3] <= 0)
+	{
+		return 0;
+	}
+
+	char *str;
+	pContext->LocalToString(params[2], &str);
+
+	// The digits are written straight into the plugin's buffer, or copied from the cache
+	size_t maxlength = static_cast<size_t>(params[3]);
+	size_t length = bigint->writeString(base, str, maxlength);
+
+	return static_cast<cell_t>(length < maxlength ? length : maxlength - 1);
+}
+
+
+
+// Length of the String of a BigInt
+cell_t BigInt_GetStringLength(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int base = params[2];
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (base < 2 || base > 36)
+	{
+		return pContext->ThrowNativeError("Invalid base %d", base);
+	}
+
+	// The string is usually wanted right after its length, so convert and cache it
+	return static_cast<cell_t>(bigint->toString(base).size());
+}
+
+
+
+// Creates a BigInt from a byte array
+cell_t BigInt_FromBytes(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *bytes;
+	int length = params[2];
+	bool littleEndian = (params[3] == BYTE_ORDER_LITTLE_ENDIAN);
+	bool twosComplement = (params[4] != 0);
+
+	pContext->LocalToPhysAddr(params[1], &bytes);
+
+	if (length < 0)
+	{
+		return pContext->ThrowNativeError("Invalid length %d", length);
+	}
+
+	// Plugins pass one byte per cell, which the conversion reads as is
+	BigUnsigned value(bytesToBigUnsigned(bytes, length, littleEndian));
+	BigIntObject *bigint;
+
+	if (twosComplement)
+	{
+		bigint = new BigIntObject(twosComplementToBigInteger(value, 8 * length));
+	}
+	else
+	{
+		bigint = new BigIntObject(value);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Byte array from BigInt
+cell_t BigInt_ToBytes(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *bytes;
+
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int maxlength = params[3];
+	bool littleEndian = (params[4] == BYTE_ORDER_LITTLE_ENDIAN);
+	bool twosComplement = (params[5] != 0);
+
+	pContext->LocalToPhysAddr(params[2], &bytes);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (!twosComplement && bigint->getSign() == BigInteger::negative)
+	{
+		return pContext->ThrowNativeError("Negative BigInt needs two's complement");
+	}
+
+	// Shortest encoding, but at least one byte
+	BigUnsigned::Index bits = twosComplement ? twosComplementBitLength(*bigint) : bigint->getMagnitude().bitLength();
+	int length = (bits > 0) ? static_cast<int>((bits + 7) / 8) : 1;
+
+	if (length > maxlength)
+	{
+		return length;
+	}
+
+	if (twosComplement)
+	{
+		bigUnsignedToBytes(bigIntegerToTwosComplement(*bigint, 8 * length), bytes, length, littleEndian);
+	}
+	else
+	{
+		bigUnsignedToBytes(bigint->getMagnitude(), bytes, length, littleEndian);
+	}
+
+	return length;
+}
+
+
+
+// Creates a BigInt from a cell array
+cell_t BigInt_FromCells(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *cells;
+	int count = params[2];
+	bool twosComplement = (params[3] != 0);
+
+	pContext->LocalToPhysAddr(params[1], &cells);
+
+	if (count < 0)
+	{
+		return pContext->ThrowNativeError("Invalid count %d", count);
+	}
+
+	// Cells are copied into the blocks as unsigned 32-bit limbs
+	BigUnsigned value(dataToBigInteger(reinterpret_cast<ucell_t *>(cells), count, BigInteger::positive).getMagnitude());
+	BigIntObject *bigint;
+
+	if (twosComplement)
+	{
+		bigint = new BigIntObject(twosComplementToBigInteger(value, 32 * count));
+	}
+	else
+	{
+		bigint = new BigIntObject(value);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Cell array from BigInt
+cell_t BigInt_ToCells(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *cells;
+
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int maxcount = params[3];
+	bool twosComplement = (params[4] != 0);
+
+	pContext->LocalToPhysAddr(params[2], &cells);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (!twosComplement && bigint->getSign() == BigInteger::negative)
+	{
+		return pContext->ThrowNativeError("Negative BigInt needs two's complement");
+	}
+
+	// Shortest encoding, but at least one cell
+	BigUnsigned::Index bits = twosComplement ? twosComplementBitLength(*bigint) : bigint->getMagnitude().bitLength();
+	int count = (bits > 0) ? static_cast<int>((bits + 31) / 32) : 1;
+
+	if (count > maxcount)
+	{
+		return count;
+	}
+
+	if (twosComplement)
+	{
+		bigUnsignedToData(bigIntegerToTwosComplement(*bigint, 32 * count), reinterpret_cast<ucell_t *>(cells), count);
+	}
+	else
+	{
+		bigUnsignedToData(bigint->getMagnitude(), reinterpret_cast<ucell_t *>(cells), count);
+	}
+
+	return count;
+}
+
+
+
+// Encodes a BigInt with an alphabet
+cell_t BigInt_ToAlphabet(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (bigint->getSign() == BigInteger::negative)
+	{
+		return pContext->ThrowNativeError("Negative BigInt can't be encoded with an alphabet");
+	}
+
+	char *alphabet;
+	char *str;
+	pContext->LocalToString(params[2], &alphabet);
+	pContext->LocalToString(params[3], &str);
+
+	if (params[4] <= 0)
+	{
+		return 0;
+	}
+
+	size_t maxlength = static_cast<size_t>(params[4]);
+	size_t length;
+
+	try
+	{
+		length = bigUnsignedToAlphabet(bigint->getMagnitude(), alphabet, str, maxlength);
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	return static_cast<cell_t>(length < maxlength ? length : maxlength - 1);
+}
+
+
+
+// Decodes a BigInt with an alphabet
+cell_t BigInt_FromAlphabet(IPluginContext *pContext, const cell_t *params)
+{
+	char *str;
+	char *alphabet;
+	pContext->LocalToString(params[1], &str);
+	pContext->LocalToString(params[2], &alphabet);
+
+	BigIntObject* bigint;
+
+	try
+	{
+		bigint = new BigIntObject(alphabetToBigUnsigned(str, strlen(str), alphabet));
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("Couldn't create BigInt (error %s)", error);
+	}
+
+
+	Handle_t hndl = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndl)
+	{
+		delete bigint;
+	}
+
+	return hndl;
+}
+
+
+
+// Starts streaming the String of a BigInt
+cell_t BigInt_ToStringBegin(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int base = params[2];
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (base < 2 || base > 36)
+	{
+		return pContext->ThrowNativeError("Invalid base %d", base);
+	}
+
+	// The digits are split into chunks once and kept in the stream; only base 10 is signed
+	BigDigitStream *stream;
+
+	if (base != 10)
+	{
+		stream = new BigDigitStream(bigint->getMagnitude(), base);
+	}
+	else
+	{
+		stream = new BigDigitStream(*bigint, base);
+	}
+
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntStreamType, stream, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete stream;
+	}
+
+	return hndlnew;
+}
+
+
+
+// Next part of a streamed String
+cell_t BigInt_ToStringChunk(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigDigitStream *stream;
+
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntStreamType, &sec, (void **)&stream)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (params[3] <= 0)
+	{
+		return 0;
+	}
+
+	char *str;
+	pContext->LocalToString(params[2], &str);
+
+	return static_cast<cell_t>(stream->read(str, static_cast<size_t>(params[3])));
+}
+
+
+
+// Stops streaming a String
+cell_t BigInt_ToStringEnd(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	BigDigitStream *stream;
+
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntStreamType, &sec, (void **)&stream)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = handlesys->FreeHandle(hndl, &sec)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Couldn't close Handle %x (error %d)", hndl, err);
+	}
+
+	return 1;
+}
+
+
+
+// Get Sign of BigInt
+cell_t BigInt_GetSign(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	return (int)bigint->getSign();
+}
+
+
+
+// Compare two BigInts
+cell_t BigInt_CompareTo(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	// Strings that are already there can be compared without parsing
+	BigInteger::CmpRes result;
+
+	if (bigint->compareStrings(*bigint2, result))
+	{
+		return (int)result;
+	}
+
+	if (bigint->isDecimal())
+	{
+		bigint->toDecimal();
+		bigint2->toDecimal();
+
+		return (int)bigint->compareDecimal(*bigint2);
+	}
+
+	bigint->parse();
+	bigint2->parse();
+
+	return (int)bigint->compareTo(*bigint2);
+}
+
+
+
+// Negates a BigInt
+cell_t BigInt_Negate(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigIntObject *bigint;
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (bigint->isDecimal())
+	{
+		bigint->toDecimal();
+
+		if (params[2] == RETURN_NEW)
+		{
+			BigIntObject *newInt = new BigIntObject(bigint->getDecimalMagnitude(), BigInteger::Sign(-bigint->getDecimalSign()));
+
+			Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+			if (!hndlnew)
+			{
+				delete newInt;
+			}
+
+			return hndlnew;
+		}
+
+		bigint->negateDecimal();
+
+		return hndl;
+	}
+
+	bigint->parse();
+
+	if (params[2] == RETURN_NEW)
+	{
+		BigIntObject *newInt = new BigIntObject(-(*bigint));
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		bigint->negate(*bigint);
+		bigint->valueChanged();
+	}
+
+	return hndl;
+}
+
+
+
+// Adds or subtracts two BigInts in decimal limbs
+cell_t AddDecimal(IPluginContext *pContext, Handle_t hndl, BigIntObject *bigint, BigIntObject *bigint2, cell_t mode, bool subtract)
+{
+	bigint->toDecimal();
+	bigint2->toDecimal();
+
+	if (mode == RETURN_NEW)
+	{
+		BigIntObject *newInt = new BigIntObject(BigUnsignedInDecimal(), BigInteger::zero);
+
+		newInt->addDecimal(*bigint, *bigint2, subtract);
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+
+	bigint->addDecimal(*bigint, *bigint2, subtract);
+
+	return hndl;
+}
+
+
+
+// Adds to BigInts
+cell_t BigInt_Add(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	// The result has the representation of the first BigInt
+	if (bigint->isDecimal())
+	{
+		return AddDecimal(pContext, hndl, bigint, bigint2, params[3], false);
+	}
+
+	bigint->parse();
+	bigint2->parse();
+
+
+	if (params[3] == RETURN_NEW)
+	{
+		BigIntObject *newInt;
+
+		try
+		{
+			newInt = new BigIntObject((*bigint) + (*bigint2));
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		}
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		try
+		{
+			(*bigint) += (*bigint2);
+			bigint->valueChanged();
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+		}
+	}
+
+	return hndl;
+}
+
+
+
+// Subtracts two BigInts
+cell_t BigInt_Subtract(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2, false)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	// The result has the representation of the first BigInt
+	if (bigint->isDecimal())
+	{
+		return AddDecimal(pContext, hndl, bigint, bigint2, params[3], true);
+	}
+
+	bigint->parse();
+	bigint2->parse();
+
+
+	if (params[3] == RETURN_NEW)
+	{
+		BigIntObject *newInt;
+
+		try
+		{
+			newInt = new BigIntObject((*bigint) - (*bigint2));
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		}
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		try
+		{
+			(*bigint) -= (*bigint2);
+			bigint->valueChanged();
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+		}
+	}
+
+	return hndl;
+}
+
+
+
+// Multiply to BigInts
+cell_t BigInt_Multiply(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	if (params[3] == RETURN_NEW)
+	{
+		BigIntObject *newInt;
+
+		try
+		{
+			newInt = new BigIntObject((*bigint) * (*bigint2));
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		}
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndl)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		try
+		{
+			(*bigint) *= (*bigint2);
+			bigint->valueChanged();
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+		}
+	}
+
+	return hndl;
+}
+
+
+
+// Divide two BigInts
+cell_t BigInt_Divide(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	if (params[3] == RETURN_NEW)
+	{
+		BigIntObject *newInt;
+
+		try
+		{
+			newInt = new BigIntObject((*bigint) / (*bigint2));
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		}
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		try
+		{
+			(*bigint) /= (*bigint2);
+			bigint->valueChanged();
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+		}
+	}
+
+	return hndl;
+}
+
+
+
+// Return remainder of divide
+cell_t BigInt_DivideRemainder(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+
+	if (params[3] == RETURN_NEW)
+	{
+		BigIntObject *newInt;
+
+		try
+		{
+			newInt = new BigIntObject((*bigint) % (*bigint2));
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		}
 
 		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-		if (!hndlnew)
-		{
-			delete newInt;
-		}
+		if (!hndlnew)
+		{
+			delete newInt;
+		}
+
+		return hndlnew;
+	}
+	else
+	{
+		try
+		{
+			(*bigint) %= (*bigint2);
+			bigint->valueChanged();
+		}
+		catch (char *error)
+		{
+			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+		}
+	}
+
+	return hndl;
+}
+
+
+
+// Uses BitAnd on BigInteger
+cell_t BigInt_BitAnd(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject((bigint->getMagnitude()) & (bigint2->getMagnitude()));
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+// Uses BitOr
+cell_t BigInt_BitOr(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject((bigint->getMagnitude()) | (bigint2->getMagnitude()));
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+// Uses Bit Xor
+cell_t BigInt_BitXor(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject((bigint->getMagnitude()) ^ (bigint2->getMagnitude()));
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+// Uses BitShiftLeft
+cell_t BigInt_BitShiftLeft(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject((bigint->getMagnitude()) << params[2]);
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+// Uses BitShiftRight
+cell_t BigInt_BitShiftRight(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	BigIntObject *newInt;
+	
+	try
+	{
+		newInt = new BigIntObject((bigint->getMagnitude()) >> params[2]);
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+// GCF of two big ints
+cell_t BigInt_GCD(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject(gcd(bigint->getMagnitude(), bigint2->getMagnitude()));
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+
+// Euclidean from Bigints
+cell_t BigInt_Euclidean(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *hndl3;
+	cell_t *hndl4;
+	cell_t *hndl5;
+
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+
+	pContext->LocalToPhysAddr(params[3], &hndl3);
+	pContext->LocalToPhysAddr(params[4], &hndl4);
+	pContext->LocalToPhysAddr(params[5], &hndl5);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	BigInteger g, r, s;
+
+	try
+	{
+		extendedEuclidean(*bigint, *bigint2, g, r, s);
+	}
+	catch (char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+
+	if (hndl3 != NULL)
+	{
+		BigIntObject *bigint3 = new BigIntObject(g);
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		*hndl3 = *(cell_t *)&hndlnew;
+	}
+
 
-		return hndlnew;
+	if (hndl4 != NULL)
+	{
+		BigIntObject *bigint4 = new BigIntObject(r);
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint4, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		*hndl4 = *(cell_t *)&hndlnew;
 	}
-	else
+
+
+	if (hndl5 != NULL)
 	{
-		try
-		{
-			(*bigint) -= (*bigint2);
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
-		}
+		BigIntObject *bigint5 = new BigIntObject(s);
+
+		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint5, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		*hndl5 = *(cell_t *)&hndlnew;
 	}
 
-	return hndl;
+	return 1;
 }
 
 
 
-// Multiply to BigInts
-cell_t BigInt_Multiply(IPluginContext *pContext, const cell_t *params)
+// Calculate ModInv
+cell_t BigInt_ModInv(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
@@ -487,62 +2134,229 @@ cell_t BigInt_Multiply(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
+	BigIntObject *newInt;
 
-	if (params[3] == RETURN_NEW)
+	try
+	{
+		newInt = new BigIntObject(modinv(*bigint, bigint2->getMagnitude()));
+	}
+	catch (...)
+	{
+		return BAD_HANDLE;
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
 	{
-		BigInteger *newInt;
+		delete newInt;
+	}
 
-		try
+	return hndlnew;
+}
+
+
+
+// Calculates ModExp
+cell_t BigInt_ModExp(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	Handle_t hndl3 = static_cast<Handle_t>(params[3]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE || hndl3 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+	BigIntObject *bigint3;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl3, &sec, &bigint3)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl3, err);
+	}
+
+
+	if (bigint3->isZero())
+	{
+		return pContext->ThrowNativeError("Modulus is zero");
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject(modexp(*bigint, bigint2->getMagnitude(), bigint3->getMagnitude()));
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+
+// Calculates ModMul
+cell_t BigInt_ModMul(IPluginContext *pContext, const cell_t *params)
+{
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	Handle_t hndl3 = static_cast<Handle_t>(params[3]);
+
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE || hndl3 == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+	}
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
+	BigIntObject *bigint3;
+
+
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
+	}
+
+	if ((err = ReadBigIntHandle(hndl3, &sec, &bigint3)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl3, err);
+	}
+
+
+	if (bigint3->isZero())
+	{
+		return pContext->ThrowNativeError("Modulus is zero");
+	}
+
+	BigIntObject *newInt;
+
+	try
+	{
+		newInt = new BigIntObject(modmul(*bigint, *bigint2, BigModulus(bigint3->getMagnitude())));
+	}
+	catch (const char *error)
+	{
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+	}
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newInt;
+	}
+
+	return hndlnew;
+}
+
+
+
+
+// Creates an elliptic curve
+cell_t BigInt_ECCreateCurve(IPluginContext *pContext, const cell_t *params)
+{
+	BigIntObject *values[6];
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+
+	for (int i = 0; i < 6; i++)
+	{
+		Handle_t hndl = static_cast<Handle_t>(params[i + 1]);
+
+		if (hndl == BAD_HANDLE)
 		{
-			newInt = new BigInteger((*bigint) * (*bigint2));
+			return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 		}
-		catch (char *error)
+
+		if ((err = ReadBigIntHandle(hndl, &sec, &values[i])) != HandleError_None)
 		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+			return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 		}
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-		if (!hndl)
+		if (values[i]->getSign() == BigInteger::negative)
 		{
-			delete newInt;
+			return pContext->ThrowNativeError("Curve parameters must not be negative");
 		}
+	}
 
-		return hndlnew;
+
+	BigEllipticCurve *curve;
+
+	try
+	{
+		BigCurvePoint generator(values[3]->getMagnitude(), values[4]->getMagnitude());
+
+		curve = new BigEllipticCurve(values[0]->getMagnitude(), values[1]->getMagnitude(), values[2]->getMagnitude(), generator, values[5]->getMagnitude());
 	}
-	else
+	catch (const char *error)
 	{
-		try
-		{
-			(*bigint) *= (*bigint2);
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
-		}
+		return pContext->ThrowNativeError("Couldn't create curve (error %s)", error);
 	}
 
-	return hndl;
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntCurveType, curve, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete curve;
+	}
+
+	return hndlnew;
 }
 
 
 
-// Divide two BigInts
-cell_t BigInt_Divide(IPluginContext *pContext, const cell_t *params)
+// Creates a point from its coordinates
+cell_t BigInt_ECCreatePoint(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
@@ -555,67 +2369,131 @@ cell_t BigInt_Divide(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
+	if (bigint->getSign() == BigInteger::negative || bigint2->getSign() == BigInteger::negative)
+	{
+		return pContext->ThrowNativeError("Point coordinates must not be negative");
+	}
+
 
-	if (params[3] == RETURN_NEW)
+	BigCurvePoint *point = new BigCurvePoint(bigint->getMagnitude(), bigint2->getMagnitude());
+
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntPointType, point, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
 	{
-		BigInteger *newInt;
+		delete point;
+	}
 
-		try
-		{
-			newInt = new BigInteger((*bigint) / (*bigint2));
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
-		}
+	return hndlnew;
+}
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-		if (!hndlnew)
-		{
-			delete newInt;
-		}
 
-		return hndlnew;
+// Gets the coordinates of a point
+cell_t BigInt_ECGetPoint(IPluginContext *pContext, const cell_t *params)
+{
+	cell_t *hndl2;
+	cell_t *hndl3;
+
+	Handle_t hndl = static_cast<Handle_t>(params[1]);
+
+	pContext->LocalToPhysAddr(params[2], &hndl2);
+	pContext->LocalToPhysAddr(params[3], &hndl3);
+
+	if (hndl == BAD_HANDLE)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
-	else
+
+	HandleError err;
+	HandleSecurity sec(NULL, myself->GetIdentity());
+	BigCurvePoint *point;
+
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntPointType, &sec, (void **)&point)) != HandleError_None)
 	{
-		try
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+	}
+
+	if (point->infinity)
+	{
+		return 0;
+	}
+
+
+	Handle_t hndlnew2 = 0;
+
+	if (hndl2 != NULL)
+	{
+		BigIntObject *bigint2 = new BigIntObject(point->x);
+
+		hndlnew2 = handlesys->CreateHandle(g_BigIntType, bigint2, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew2)
 		{
-			(*bigint) /= (*bigint2);
+			delete bigint2;
+
+			return pContext->ThrowNativeError("Couldn't create Handle for x");
 		}
-		catch (char *error)
+	}
+
+
+	if (hndl3 != NULL)
+	{
+		BigIntObject *bigint3 = new BigIntObject(point->y);
+
+		Handle_t hndlnew3 = handlesys->CreateHandle(g_BigIntType, bigint3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+		if (!hndlnew3)
 		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
+			delete bigint3;
+
+			// Don't leave the handle of x behind
+			if (hndlnew2)
+			{
+				HandleSecurity owner(pContext->GetIdentity(), myself->GetIdentity());
+
+				handlesys->FreeHandle(hndlnew2, &owner);
+			}
+
+			return pContext->ThrowNativeError("Couldn't create Handle for y");
 		}
+
+		*hndl3 = *(cell_t *)&hndlnew3;
 	}
 
-	return hndl;
+
+	if (hndl2 != NULL)
+	{
+		*hndl2 = *(cell_t *)&hndlnew2;
+	}
+
+	return 1;
 }
 
 
 
-// Return remainder of divide
-cell_t BigInt_DivideRemainder(IPluginContext *pContext, const cell_t *params)
+// Adds two points
+cell_t BigInt_ECAdd(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	Handle_t hndl3 = static_cast<Handle_t>(params[3]);
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE || hndl3 == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
@@ -623,67 +2501,63 @@ cell_t BigInt_DivideRemainder(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigEllipticCurve *curve;
+	BigCurvePoint *point;
+	BigCurvePoint *point2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntCurveType, &sec, (void **)&curve)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl2, g_BigIntPointType, &sec, (void **)&point)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-
-	if (params[3] == RETURN_NEW)
+	if ((err = handlesys->ReadHandle(hndl3, g_BigIntPointType, &sec, (void **)&point2)) != HandleError_None)
 	{
-		BigInteger *newInt;
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl3, err);
+	}
 
-		try
-		{
-			newInt = new BigInteger((*bigint) % (*bigint2));
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
-		}
+	if (!curve->contains(*point) || !curve->contains(*point2))
+	{
+		return pContext->ThrowNativeError("Point is not on the curve");
+	}
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-		if (!hndlnew)
-		{
-			delete newInt;
-		}
+	BigCurvePoint *newPoint;
 
-		return hndlnew;
+	try
+	{
+		newPoint = new BigCurvePoint(curve->add(*point, *point2));
 	}
-	else
+	catch (const char *error)
 	{
-		try
-		{
-			(*bigint) %= (*bigint2);
-		}
-		catch (char *error)
-		{
-			return pContext->ThrowNativeError("BigIntegers Method Failed(error %s)", error);
-		}
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
-	return hndl;
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntPointType, newPoint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+	if (!hndlnew)
+	{
+		delete newPoint;
+	}
+
+	return hndlnew;
 }
 
 
 
-// Uses BitAnd on BigInteger
-cell_t BigInt_BitAnd(IPluginContext *pContext, const cell_t *params)
+// Multiplies a point with a scalar
+cell_t BigInt_ECMul(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	Handle_t hndl3 = static_cast<Handle_t>(params[3]);
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
+	if (hndl == BAD_HANDLE || hndl3 == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
@@ -691,36 +2565,58 @@ cell_t BigInt_BitAnd(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigEllipticCurve *curve;
+	BigCurvePoint *point;
+	BigIntObject *bigint;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntCurveType, &sec, (void **)&curve)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	// No point means the generator of the curve
+	if (hndl2 == BAD_HANDLE)
+	{
+		point = const_cast<BigCurvePoint *>(&curve->getGenerator());
+	}
+	else if ((err = handlesys->ReadHandle(hndl2, g_BigIntPointType, &sec, (void **)&point)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger *newInt;
+	if ((err = ReadBigIntHandle(hndl3, &sec, &bigint)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl3, err);
+	}
+
+	if (!curve->contains(*point))
+	{
+		return pContext->ThrowNativeError("Point is not on the curve");
+	}
+
+
+	BigCurvePoint *newPoint;
 
 	try
 	{
-		newInt = new BigInteger((bigint->getMagnitude()) & (bigint2->getMagnitude()));
+		newPoint = new BigCurvePoint(curve->multiply(*point, bigint->getMagnitude()));
+
+		if (bigint->getSign() == BigInteger::negative)
+		{
+			*newPoint = curve->negate(*newPoint);
+		}
 	}
-	catch (char *error)
+	catch (const char *error)
 	{
 		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntPointType, newPoint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
 	if (!hndlnew)
 	{
-		delete newInt;
+		delete newPoint;
 	}
 
 	return hndlnew;
@@ -728,8 +2624,8 @@ cell_t BigInt_BitAnd(IPluginContext *pContext, const cell_t *params)
 
 
 
-// Uses BitOr
-cell_t BigInt_BitOr(IPluginContext *pContext, const cell_t *params)
+// Verifies an ECDSA signature
+cell_t BigInt_ECVerify(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
@@ -742,175 +2638,260 @@ cell_t BigInt_BitOr(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigEllipticCurve *curve;
+	BigCurvePoint *point;
+	BigIntObject *values[3];
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntCurveType, &sec, (void **)&curve)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl2, g_BigIntPointType, &sec, (void **)&point)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger *newInt;
+	// Hash, r and s
+	for (int i = 0; i < 3; i++)
+	{
+		Handle_t hndlValue = static_cast<Handle_t>(params[i + 3]);
+
+		if (hndlValue == BAD_HANDLE)
+		{
+			return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		}
+
+		if ((err = ReadBigIntHandle(hndlValue, &sec, &values[i])) != HandleError_None)
+		{
+			return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndlValue, err);
+		}
+
+		if (values[i]->getSign() == BigInteger::negative)
+		{
+			return 0;
+		}
+	}
+
 
 	try
 	{
-		newInt = new BigInteger((bigint->getMagnitude()) | (bigint2->getMagnitude()));
+		return curve->verify(*point, values[0]->getMagnitude(), values[1]->getMagnitude(), values[2]->getMagnitude());
 	}
-	catch (char *error)
+	catch (const char *error)
 	{
 		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
-
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-	if (!hndlnew)
-	{
-		delete newInt;
-	}
-
-	return hndlnew;
 }
 
 
 
-// Uses Bit Xor
-cell_t BigInt_BitXor(IPluginContext *pContext, const cell_t *params)
+
+// Verifies a RSA signature
+cell_t BigInt_RSAVerify(IPluginContext *pContext, const cell_t *params)
 {
+	cell_t *sig;
+	cell_t *digest;
+
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
+	int sigLen = params[4];
+	int digestLen = params[6];
+
+	pContext->LocalToPhysAddr(params[3], &sig);
+	pContext->LocalToPhysAddr(params[5], &digest);
 
 	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
 
+	if (sigLen < 0 || digestLen < 0)
+	{
+		return pContext->ThrowNativeError("Invalid length");
+	}
+
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigIntObject *bigint;
+	BigIntObject *bigint2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl2, &sec, &bigint2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger *newInt;
 
-	try
+	// Plugins pass one byte per cell
+	unsigned char *sigBytes = new unsigned char[sigLen + 1];
+	unsigned char *digestBytes = new unsigned char[digestLen + 1];
+
+	for (int i = 0; i < sigLen; i++)
 	{
-		newInt = new BigInteger((bigint->getMagnitude()) ^ (bigint2->getMagnitude()));
+		sigBytes[i] = static_cast<unsigned char>(sig[i]);
 	}
-	catch (char *error)
+
+	for (int i = 0; i < digestLen; i++)
 	{
-		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		digestBytes[i] = static_cast<unsigned char>(digest[i]);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	bool valid;
 
-	if (!hndlnew)
+	try
 	{
-		delete newInt;
+		valid = rsaVerify(bigint->getMagnitude(), bigint2->getMagnitude(), sigBytes, sigLen, digestBytes, digestLen, static_cast<RSAScheme>(params[7]));
 	}
+	catch (const char *error)
+	{
+		delete [] sigBytes;
+		delete [] digestBytes;
 
-	return hndlnew;
+		return pContext->ThrowNativeError("Couldn't verify signature (error %s)", error);
+	}
+
+	delete [] sigBytes;
+	delete [] digestBytes;
+
+	return valid;
 }
 
 
 
-// Uses BitShiftLeft
-cell_t BigInt_BitShiftLeft(IPluginContext *pContext, const cell_t *params)
+
+// Generates a RSA key
+cell_t BigInt_RSAGenerate(IPluginContext *pContext, const cell_t *params)
 {
-	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	cell_t *hndls[8];
 
-	if (hndl == BAD_HANDLE)
+	int bits = params[1];
+	int exponent = params[10];
+
+	for (int i = 0; i < 8; i++)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
+		pContext->LocalToPhysAddr(params[i + 2], &hndls[i]);
 	}
 
-	HandleError err;
-	HandleSecurity sec(NULL, myself->GetIdentity());
-
-	BigInteger *bigint;
-
-
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if (bits < 64 || bits > 16384)
 	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
+		return pContext->ThrowNativeError("Invalid key size %d", bits);
 	}
 
-	BigInteger *newInt;
+	RSAKey key;
 
 	try
 	{
-		newInt = new BigInteger((bigint->getMagnitude()) << params[2]);
+		rsaGenerate(key, bits, BigUnsigned(exponent));
 	}
-	catch (char *error)
+	catch (const char *error)
 	{
-		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
+		return pContext->ThrowNativeError("Couldn't generate key (error %s)", error);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-	if (!hndlnew)
+	const BigUnsigned *values[8] = {&key.n, &key.e, &key.d, &key.p, &key.q, &key.dp, &key.dq, &key.qinv};
+	Handle_t hndlsnew[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+	for (int i = 0; i < 8; i++)
 	{
-		delete newInt;
+		if (hndls[i] != NULL)
+		{
+			BigIntObject *bigint = new BigIntObject(*values[i]);
+
+			hndlsnew[i] = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+
+			if (hndlsnew[i] == 0)
+			{
+				delete bigint;
+
+				// Don't leave the handles created so far behind
+				HandleSecurity owner(pContext->GetIdentity(), myself->GetIdentity());
+
+				for (int j = 0; j < i; j++)
+				{
+					if (hndlsnew[j] != 0)
+					{
+						handlesys->FreeHandle(hndlsnew[j], &owner);
+					}
+				}
+
+				return pContext->ThrowNativeError("Couldn't create Handle for the key");
+			}
+		}
 	}
 
-	return hndlnew;
+
+	for (int i = 0; i < 8; i++)
+	{
+		if (hndls[i] != NULL)
+		{
+			*hndls[i] = *(cell_t *)&hndlsnew[i];
+		}
+	}
+
+	return 1;
 }
 
 
 
-// Uses BitShiftRight
-cell_t BigInt_BitShiftRight(IPluginContext *pContext, const cell_t *params)
+
+// Converts a BigInt into residue number system
+cell_t BigInt_RNSCreate(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
+	int bits = params[2];
 
 	if (hndl == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
 
+	if (bits < 1)
+	{
+		return pContext->ThrowNativeError("Invalid bit count %d", bits);
+	}
+
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
+	BigIntObject *bigint;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = ReadBigIntHandle(hndl, &sec, &bigint)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	BigInteger *newInt;
-	
+	if (bigint->getSign() == BigInteger::negative)
+	{
+		return pContext->ThrowNativeError("BigInt must not be negative");
+	}
+
+
+	BigUnsignedInRNS *rns;
+
 	try
 	{
-		newInt = new BigInteger((bigint->getMagnitude()) >> params[2]);
+		rns = new BigUnsignedInRNS(bigint->getMagnitude(), BigUnsignedInRNS::sizeForBits(bits));
 	}
-	catch (char *error)
+	catch (const char *error)
 	{
 		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntRNSType, rns, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
 	if (!hndlnew)
 	{
-		delete newInt;
+		delete rns;
 	}
 
 	return hndlnew;
@@ -918,8 +2899,9 @@ cell_t BigInt_BitShiftRight(IPluginContext *pContext, const cell_t *params)
 
 
 
-// GCF of two big ints
-cell_t BigInt_GCD(IPluginContext *pContext, const cell_t *params)
+
+// Adds two values in residue number system
+cell_t BigInt_RNSAdd(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
@@ -932,36 +2914,39 @@ cell_t BigInt_GCD(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigUnsignedInRNS *rns;
+	BigUnsignedInRNS *rns2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntRNSType, &sec, (void **)&rns)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl2, g_BigIntRNSType, &sec, (void **)&rns2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger *newInt;
+
+	BigUnsignedInRNS *rns3 = new BigUnsignedInRNS();
 
 	try
 	{
-		newInt = new BigInteger(gcd(bigint->getMagnitude(), bigint2->getMagnitude()));
+		rns3->add(*rns, *rns2);
 	}
-	catch (char *error)
+	catch (const char *error)
 	{
+		delete rns3;
+
 		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntRNSType, rns3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
 	if (!hndlnew)
 	{
-		delete newInt;
+		delete rns3;
 	}
 
 	return hndlnew;
@@ -970,20 +2955,12 @@ cell_t BigInt_GCD(IPluginContext *pContext, const cell_t *params)
 
 
 
-// Euclidean from Bigints
-cell_t BigInt_Euclidean(IPluginContext *pContext, const cell_t *params)
+// Subtracts two values in residue number system
+cell_t BigInt_RNSSubtract(IPluginContext *pContext, const cell_t *params)
 {
-	cell_t *hndl3;
-	cell_t *hndl4;
-	cell_t *hndl5;
-
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
 
-	pContext->LocalToPhysAddr(params[3], &hndl3);
-	pContext->LocalToPhysAddr(params[4], &hndl4);
-	pContext->LocalToPhysAddr(params[5], &hndl5);
-
 	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
@@ -992,68 +2969,49 @@ cell_t BigInt_Euclidean(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigUnsignedInRNS *rns;
+	BigUnsignedInRNS *rns2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntRNSType, &sec, (void **)&rns)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl2, g_BigIntRNSType, &sec, (void **)&rns2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger g, r, s;
-
-	try
-	{
-		extendedEuclidean(*bigint, *bigint2, g, r, s);
-	}
-	catch (char *error)
-	{
-		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
-	}
 
+	BigUnsignedInRNS *rns3 = new BigUnsignedInRNS();
 
-	if (hndl3 != NULL)
+	try
 	{
-		BigInteger *bigint3 = new BigInteger(g);
-
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-		*hndl3 = *(cell_t *)&hndlnew;
+		rns3->subtract(*rns, *rns2);
 	}
-
-
-	if (hndl4 != NULL)
+	catch (const char *error)
 	{
-		BigInteger *bigint4 = new BigInteger(r);
+		delete rns3;
 
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint4, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-		*hndl4 = *(cell_t *)&hndlnew;
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntRNSType, rns3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
-	if (hndl5 != NULL)
+	if (!hndlnew)
 	{
-		BigInteger *bigint5 = new BigInteger(s);
-
-		Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint5, pContext->GetIdentity(), myself->GetIdentity(), NULL);
-
-		*hndl5 = *(cell_t *)&hndlnew;
+		delete rns3;
 	}
 
-	return 1;
+	return hndlnew;
 }
 
 
 
-// Calculate ModInv
-cell_t BigInt_ModInv(IPluginContext *pContext, const cell_t *params)
+
+// Multiplies two values in residue number system
+cell_t BigInt_RNSMultiply(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
 	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
@@ -1066,36 +3024,39 @@ cell_t BigInt_ModInv(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
+	BigUnsignedInRNS *rns;
+	BigUnsignedInRNS *rns2;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntRNSType, &sec, (void **)&rns)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl2, g_BigIntRNSType, &sec, (void **)&rns2)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
 	}
 
-	BigInteger *newInt;
+
+	BigUnsignedInRNS *rns3 = new BigUnsignedInRNS();
 
 	try
 	{
-		newInt = new BigInteger(modinv(*bigint, bigint2->getMagnitude()));
+		rns3->multiply(*rns, *rns2);
 	}
-	catch (...)
+	catch (const char *error)
 	{
-		return BAD_HANDLE;
+		delete rns3;
+
+		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
 	}
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntRNSType, rns3, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
 	if (!hndlnew)
 	{
-		delete newInt;
+		delete rns3;
 	}
 
 	return hndlnew;
@@ -1103,14 +3064,13 @@ cell_t BigInt_ModInv(IPluginContext *pContext, const cell_t *params)
 
 
 
-// Calculates ModExp
-cell_t BigInt_ModExp(IPluginContext *pContext, const cell_t *params)
+
+// Converts a value in residue number system back into a BigInt
+cell_t BigInt_RNSToBigInt(IPluginContext *pContext, const cell_t *params)
 {
 	Handle_t hndl = static_cast<Handle_t>(params[1]);
-	Handle_t hndl2 = static_cast<Handle_t>(params[2]);
-	Handle_t hndl3 = static_cast<Handle_t>(params[3]);
 
-	if (hndl == BAD_HANDLE || hndl2 == BAD_HANDLE || hndl3 == BAD_HANDLE)
+	if (hndl == BAD_HANDLE)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %i", BAD_HANDLE);
 	}
@@ -1118,43 +3078,22 @@ cell_t BigInt_ModExp(IPluginContext *pContext, const cell_t *params)
 	HandleError err;
 	HandleSecurity sec(NULL, myself->GetIdentity());
 
-	BigInteger *bigint;
-	BigInteger *bigint2;
-	BigInteger *bigint3;
+	BigUnsignedInRNS *rns;
 
 
-	if ((err = handlesys->ReadHandle(hndl, g_BigIntType, &sec, (void **)&bigint)) != HandleError_None)
+	if ((err = handlesys->ReadHandle(hndl, g_BigIntRNSType, &sec, (void **)&rns)) != HandleError_None)
 	{
 		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl, err);
 	}
 
-	if ((err = handlesys->ReadHandle(hndl2, g_BigIntType, &sec, (void **)&bigint2)) != HandleError_None)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl2, err);
-	}
-
-	if ((err = handlesys->ReadHandle(hndl3, g_BigIntType, &sec, (void **)&bigint3)) != HandleError_None)
-	{
-		return pContext->ThrowNativeError("Invalid Handle %x (error %d)", hndl3, err);
-	}
-
-
-	BigInteger *newInt;
 
-	try
-	{
-		newInt = new BigInteger(modexp(*bigint, bigint2->getMagnitude(), bigint3->getMagnitude()));
-	}
-	catch (char *error)
-	{
-		return pContext->ThrowNativeError("BigIntegers Method Failed (error %s)", error);
-	}
+	BigIntObject *bigint = new BigIntObject(BigUnsigned(*rns));
 
-	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, newInt, pContext->GetIdentity(), myself->GetIdentity(), NULL);
+	Handle_t hndlnew = handlesys->CreateHandle(g_BigIntType, bigint, pContext->GetIdentity(), myself->GetIdentity(), NULL);
 
 	if (!hndlnew)
 	{
-		delete newInt;
+		delete bigint;
 	}
 
 	return hndlnew;
@@ -28,11 +28,197 @@
 
 #include "smsdk_ext.h"
 #include "BigIntegerLibrary.hh"
+#include <string>
 
 
 
 
 
+/**
+ * What a BigInt Handle holds: the value and the string it was last converted to,
+ * so that converting an unchanged value again is only a copy.
+ * A lazy BigInt starts out with only its string and parses it on first use.
+ * A decimal BigInt keeps its value in decimal limbs, where adding, subtracting,
+ * comparing and converting to a base 10 string need no division; anything else
+ * converts it to binary first.
+ * Natives that change the binary value in place have to call valueChanged.
+ */
+class BigIntObject : public BigInteger
+{
+public:
+	BigIntObject(const BigInteger &x) : BigInteger(x), parsed(true), decimal(false), decimalValid(false), stringBase(0), missedBase(0) {}
+
+	// Takes over the blocks of a result instead of copying them
+	BigIntObject(BigInteger &&x) : BigInteger(std::move(x)), parsed(true), decimal(false), decimalValid(false), stringBase(0), missedBase(0) {}
+
+	/**
+	 * BigInt objects come from the pool, so the objects that OnHandleDestroy
+	 * deletes are reused by the next natives that create BigInts.
+	 */
+	static void *operator new(size_t size)
+	{
+		return poolAllocate(size);
+	}
+
+	static void operator delete(void *object, size_t size)
+	{
+		poolFree(object, size);
+	}
+
+	/**
+	 * Creates a decimal BigInt.
+	 *
+	 * @param magnitude    Magnitude in decimal limbs.
+	 * @param sign         Sign, which has to be zero if the magnitude is.
+	 */
+	BigIntObject(const BigUnsignedInDecimal &magnitude, BigInteger::Sign sign)
+		: parsed(false), decimal(true), decimalValid(true), decimalMagnitude(magnitude), decimalSign(sign), stringBase(0), missedBase(0) {}
+
+	/**
+	 * Creates a lazy BigInt, checking the string but not parsing it yet.
+	 * Throws on a bad symbol.
+	 *
+	 * @param str          String of digits, with a sign only in base 10.
+	 * @param length       Length of the string.
+	 * @param base         Base from 2 to 36.
+	 */
+	BigIntObject(const char *str, size_t length, int base);
+
+	/**
+	 * Parses the string of a lazy BigInt; arithmetic needs this first.
+	 */
+	void parse()
+	{
+		if (!parsed)
+		{
+			parseString();
+		}
+	}
+
+	/**
+	 * Returns whether arithmetic on this BigInt should use decimal limbs.
+	 */
+	bool isDecimal() const
+	{
+		return decimal;
+	}
+
+	/**
+	 * Converts the value to decimal limbs, if they don't hold it already.
+	 */
+	void toDecimal();
+
+	/**
+	 * Sets this decimal BigInt to a + b or a - b, which may both be this.
+	 * Both have to hold their value in decimal limbs.
+	 *
+	 * @param a            First operand.
+	 * @param b            Second operand.
+	 * @param subtract     Whether to subtract b instead of adding it.
+	 */
+	void addDecimal(const BigIntObject &a, const BigIntObject &b, bool subtract);
+
+	/**
+	 * Compares the decimal limbs of two BigInts that both hold them.
+	 *
+	 * @param x            BigInt to compare with.
+	 * @return             Result of the comparison.
+	 */
+	BigInteger::CmpRes compareDecimal(const BigIntObject &x) const;
+
+	/**
+	 * Negates the decimal limbs of this BigInt, which has to hold them.
+	 */
+	void negateDecimal();
+
+	/**
+	 * Returns the magnitude in decimal limbs, if they hold the value.
+	 */
+	const BigUnsignedInDecimal &getDecimalMagnitude() const
+	{
+		return decimalMagnitude;
+	}
+
+	/**
+	 * Returns the sign of the decimal limbs, if they hold the value.
+	 */
+	BigInteger::Sign getDecimalSign() const
+	{
+		return decimalSign;
+	}
+
+	/**
+	 * Compares two BigInts by their strings, without parsing them.
+	 * Works if both strings are in base 10, or both are still unparsed in the same base.
+	 *
+	 * @param x            BigInt to compare with.
+	 * @param result       Result of the comparison.
+	 * @return             True if the strings could be compared.
+	 */
+	bool compareStrings(const BigIntObject &x, BigInteger::CmpRes &result) const;
+
+	/**
+	 * Returns the value as BigInt_ToString writes it, converting only if needed.
+	 *
+	 * @param base         Base from 2 to 36; only base 10 is signed.
+	 * @return             The cached string.
+	 */
+	const std::string &toString(int base);
+
+	/**
+	 * Writes the value like BigInt_ToString into a buffer, straight from the
+	 * number unless the cache holds it. The string is only cached when the
+	 * same value is written in the same base a second time.
+	 *
+	 * @param base         Base from 2 to 36; only base 10 is signed.
+	 * @param buf          Buffer to write to.
+	 * @param size         Size of the buffer, at least 1.
+	 * @return             Full length of the string, like snprintf.
+	 */
+	size_t writeString(int base, char *buf, size_t size);
+
+	/**
+	 * Forgets the cached string and decimal limbs after the binary value was changed.
+	 */
+	void valueChanged()
+	{
+		decimalValid = false;
+		stringBase = 0;
+		missedBase = 0;
+		std::string().swap(cachedString);
+	}
+
+private:
+	void parseString();
+	void cacheStream(BigDigitStream &stream, int base);
+
+	// Whether the BigInteger holds the value; if not, the decimal limbs or the string do
+	bool parsed;
+	bool decimal;
+	bool decimalValid;
+	BigUnsignedInDecimal decimalMagnitude;
+	BigInteger::Sign decimalSign;
+	int stringBase;
+	std::string cachedString;
+	// Base of the last string written without filling the cache
+	int missedBase;
+};
+
+
+
+/**
+ * Reads the object of a BigInt Handle.
+ *
+ * @param hndl         Handle to read.
+ * @param sec          Security descriptor.
+ * @param bigint       Pointer to store the object in.
+ * @param parse        Whether a lazy BigInt should be parsed.
+ * @return             HandleError_None on success.
+ */
+HandleError ReadBigIntHandle(Handle_t hndl, const HandleSecurity *sec, BigIntObject **bigint, bool parse = true);
+
+
+
 class BigIntExtension : public SDKExtension, public IHandleTypeDispatch
 {
 public:
@@ -47,6 +233,12 @@ public:
 	virtual bool SDK_OnLoad(char *error, size_t maxlength, bool late);
 
 
+	/**
+	 * This is called right before the extension is unloaded.
+	 */
+	virtual void SDK_OnUnload();
+
+
 	/**
 	 * Called when destroying a handle. Must be implemented.
 	 *
@@ -61,8 +253,20 @@ public:
 
 cell_t BigInt_Create(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_CreateFromString(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_CreateLazy(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_CreateDecimal(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_ToInt(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_ToString(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_GetStringLength(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToStringBegin(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToStringChunk(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToStringEnd(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_FromBytes(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToBytes(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_FromCells(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToCells(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ToAlphabet(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_FromAlphabet(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_GetSign(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_CompareTo(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_Negate(IPluginContext *pContext, const cell_t *params);
@@ -80,6 +284,20 @@ cell_t BigInt_GCD(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_Euclidean(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_ModInv(IPluginContext *pContext, const cell_t *params);
 cell_t BigInt_ModExp(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ModMul(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECCreateCurve(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECCreatePoint(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECGetPoint(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECAdd(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECMul(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_ECVerify(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RSAVerify(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RSAGenerate(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RNSCreate(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RNSAdd(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RNSSubtract(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RNSMultiply(IPluginContext *pContext, const cell_t *params);
+cell_t BigInt_RNSToBigInt(IPluginContext *pContext, const cell_t *params);
 
 
 #endif
\ No newline at end of file